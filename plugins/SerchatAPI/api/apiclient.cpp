@@ -5,6 +5,29 @@
 #include <QFile>
 #include <QFileInfo>
 
+namespace {
+// Streamed list items are parsed and announced in batches of this size
+const int kStreamBatchItems = 100;
+
+// How urgently NetworkClient should fetch each kind of GET
+NetworkClient::Priority priorityFor(RequestType type) {
+    switch (type) {
+    case RequestType::ServerMembers:
+    case RequestType::ServerRoles:
+    case RequestType::ServerEmojis:
+    case RequestType::AllEmojis:
+    case RequestType::Friends:
+        return NetworkClient::Priority::Prefetch;
+    case RequestType::Profile:
+    case RequestType::SingleEmoji:
+    case RequestType::SystemInfo:
+        return NetworkClient::Priority::Background;
+    default:
+        return NetworkClient::Priority::Interactive;
+    }
+}
+}
+
 ApiClient::ApiClient(NetworkClient* networkClient, QObject* parent)
     : ApiBase(parent)
     , m_networkClient(networkClient)
@@ -38,6 +61,23 @@ void ApiClient::cancelRequest(int requestId) {
     if (req.reply) {
         req.reply->abort();
         req.reply->deleteLater();
+    } else if (req.ticket) {
+        // Not sent yet: hand the slot to another request waiting on the
+        // endpoint, or take it out of the queue if nobody else wants it
+        QList<int> waiting = m_endpointToRequests.value(req.endpoint);
+        if (waiting.isEmpty()) {
+            m_networkClient->cancelScheduled(req.ticket);
+        } else {
+            m_pendingRequests[waiting.first()].ticket = req.ticket;
+        }
+    }
+    
+    // Downloaded but still parsing: another waiting request takes it over
+    if (req.stream && req.stream->finished) {
+        QList<int> waiting = m_endpointToRequests.value(req.endpoint);
+        if (!waiting.isEmpty()) {
+            m_pendingRequests[waiting.first()].stream = req.stream;
+        }
     }
     
     m_pendingRequests.remove(requestId);
@@ -55,6 +95,10 @@ bool ApiClient::isRequestPending(int requestId) const {
     return m_pendingRequests.contains(requestId);
 }
 
+void ApiClient::cancelQueuedBackgroundRequests() {
+    m_networkClient->dropQueued(NetworkClient::Priority::Background);
+}
+
 void ApiClient::cleanupRequest(int requestId) {
     if (!m_pendingRequests.contains(requestId)) {
         return;
@@ -80,6 +124,12 @@ void ApiClient::cleanupRequest(int requestId) {
 int ApiClient::startGetRequest(RequestType type, const QString& endpoint, 
                                 const QString& cacheKey, bool useCache,
                                 const QVariantMap& context) {
+    return startGetRequest(type, priorityFor(type), endpoint, cacheKey, useCache, context);
+}
+
+int ApiClient::startGetRequest(RequestType type, NetworkClient::Priority priority,
+                                const QString& endpoint, const QString& cacheKey,
+                                bool useCache, const QVariantMap& context) {
     int requestId = generateRequestId();
     
     if (m_baseUrl.isEmpty()) {
@@ -106,6 +156,21 @@ int ApiClient::startGetRequest(RequestType type, const QString& endpoint,
             }, Qt::QueuedConnection);
             return requestId;
         }
+        
+        // Cold start: answer from the disk copy now, refresh behind it.
+        // The refresh completes under its own request ID, so the usual
+        // signal handlers pick up whatever changed.
+        if (takeRestoredCache(cacheKey, cachedData)) {
+            qDebug() << "[ApiClient] Serving restored copy for:" << cacheKey;
+            QMetaObject::invokeMethod(this, [this, requestId, type, context, cachedData]() {
+                PendingRequest req;
+                req.type = type;
+                req.context = context;
+                emitSuccess(requestId, req, cachedData);
+            }, Qt::QueuedConnection);
+            startGetRequest(type, priority, endpoint, cacheKey, false, context);
+            return requestId;
+        }
     }
     
     // Check for request deduplication
@@ -119,30 +184,50 @@ int ApiClient::startGetRequest(RequestType type, const QString& endpoint,
         pending.cacheKey = cacheKey;
         pending.type = type;
         pending.context = context;
+        pending.priority = priority;
         m_pendingRequests[requestId] = pending;
         
+        // Still queued: it now has to be as quick as the most urgent waiter
+        const QList<int> waiting = m_endpointToRequests.value(endpoint);
+        for (int waitingId : waiting) {
+            int ticket = m_pendingRequests.value(waitingId).ticket;
+            if (ticket) {
+                if (m_networkClient->promote(ticket, priority)) {
+                    qDebug() << "[ApiClient] Promoted queued request for:" << endpoint;
+                }
+                break;
+            }
+        }
+        
         return requestId;
     }
     
-    // Make the actual network request
-    QUrl url = buildUrl(m_baseUrl, endpoint);
-    QNetworkReply* reply = m_networkClient->get(url);
-    
     // Track the request
     PendingRequest pending;
-    pending.reply = reply;
     pending.endpoint = endpoint;
     pending.cacheKey = cacheKey;
     pending.type = type;
     pending.context = context;
+    pending.priority = priority;
+    if (isStreamedList(type)) {
+        pending.stream = QSharedPointer<ListStream>::create();
+    }
     m_pendingRequests[requestId] = pending;
     
     // Track endpoint -> requestIds for deduplication
     m_endpointToRequests[endpoint].append(requestId);
     
-    // Store requestId in reply for lookup in slot
-    reply->setProperty("requestId", requestId);
-    connect(reply, &QNetworkReply::finished, this, &ApiClient::onReplyFinished);
+    // Make the actual network request (conditional if we hold a copy,
+    // even when the caller bypassed the cache). Interactive requests start
+    // right here; the rest may wait for a free slot.
+    QUrl url = buildUrl(m_baseUrl, endpoint);
+    int ticket = m_networkClient->scheduleGet(url, conditionalHeaders(cacheKey), priority,
+        [this, endpoint](QNetworkReply* reply) { attachReply(endpoint, reply); },
+        [this, endpoint]() { onRequestDropped(endpoint); });
+    
+    if (m_pendingRequests.contains(requestId) && !m_pendingRequests[requestId].reply) {
+        m_pendingRequests[requestId].ticket = ticket;
+    }
     
     qDebug() << "[ApiClient] Started request" << requestId << "for" << endpoint;
     return requestId;
@@ -345,13 +430,59 @@ void ApiClient::onReplyFinished() {
     QString endpoint = primary.endpoint;
     QString cacheKey = primary.cacheKey;
     
-    // Process the reply
-    ApiResult result = handleReply(reply);
-    reply->deleteLater();
+    // Not modified: the cached copy is still current
+    int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (statusCode == 304) {
+        ApiResult result;
+        result.statusCode = statusCode;
+        result.success = revalidateCache(cacheKey, primary.context, result.data);
+        if (!result.success && !reply->property("unconditional").toBool()) {
+            // Cleared while the request was out; get the whole thing
+            reply->deleteLater();
+            retryUnconditional(primaryRequestId);
+            return;
+        }
+        if (!result.success) {
+            result.errorMessage = "Not modified, but nothing cached";
+        }
+        reply->deleteLater();
+        onReplyParsed(endpoint, QString(), result);
+        return;
+    }
     
+    QByteArray etag = reply->rawHeader("ETag");
+    QByteArray lastModified = reply->rawHeader("Last-Modified");
+    
+    // Streamed lists have been parsed as they arrived; the rest of the
+    // body may still be on the parse workers
+    if (primary.stream && primary.stream->active) {
+        QSharedPointer<ListStream> stream = primary.stream;
+        stream->etag = etag;
+        stream->lastModified = lastModified;
+        primary.reply = nullptr;  // Cancelling from here on mustn't touch it
+        primary.ticket = 0;
+        finishListStream(endpoint, stream, reply);
+        reply->deleteLater();
+        return;
+    }
+    
+    // The reply is done and about to go; waiters cancelled while the body
+    // parses must not touch it, and onReplyParsed() completes the rest
+    primary.reply = nullptr;
+    primary.ticket = 0;
+    
+    // Process the reply; large bodies are parsed off the GUI thread
+    handleReplyAsync(reply, [this, endpoint, cacheKey, etag, lastModified](const ApiResult& result) {
+        onReplyParsed(endpoint, cacheKey, result, etag, lastModified);
+    });
+    reply->deleteLater();
+}
+
+void ApiClient::onReplyParsed(const QString& endpoint, const QString& cacheKey, const ApiResult& result,
+                              const QByteArray& etag, const QByteArray& lastModified) {
     // Cache successful results
     if (result.success && !cacheKey.isEmpty()) {
-        updateCache(cacheKey, result.data);
+        updateCache(cacheKey, result.data, etag, lastModified);
     }
     
     // Get all requestIds waiting for this endpoint
@@ -363,6 +494,65 @@ void ApiClient::onReplyFinished() {
     }
 }
 
+void ApiClient::attachReply(const QString& endpoint, QNetworkReply* reply) {
+    // Whoever scheduled this may have been cancelled while it was queued;
+    // any request still waiting on the endpoint can own the reply
+    QList<int> waiting = m_endpointToRequests.value(endpoint);
+    if (waiting.isEmpty()) {
+        reply->abort();
+        reply->deleteLater();
+        return;
+    }
+    
+    int requestId = waiting.first();
+    PendingRequest& req = m_pendingRequests[requestId];
+    req.reply = reply;
+    req.ticket = 0;
+    
+    // Store requestId in reply for lookup in slot
+    reply->setProperty("requestId", requestId);
+    connect(reply, &QNetworkReply::finished, this, &ApiClient::onReplyFinished);
+    if (req.stream) {
+        connect(reply, &QNetworkReply::readyRead, this, &ApiClient::onReplyReadyRead);
+    }
+}
+
+void ApiClient::retryUnconditional(int requestId) {
+    PendingRequest& req = m_pendingRequests[requestId];
+    req.reply = nullptr;
+    const QString endpoint = req.endpoint;
+    qDebug() << "[ApiClient] Not modified, but nothing cached; refetching:" << endpoint;
+    
+    // As urgent as the most urgent request waiting on it
+    NetworkClient::Priority priority = req.priority;
+    const QList<int> waiting = m_endpointToRequests.value(endpoint);
+    for (int waitingId : waiting) {
+        priority = qMin(priority, m_pendingRequests.value(waitingId).priority);
+    }
+    
+    QUrl url = buildUrl(m_baseUrl, endpoint);
+    int ticket = m_networkClient->scheduleGet(url, QVariantMap(), priority,
+        [this, endpoint](QNetworkReply* reply) {
+            reply->setProperty("unconditional", true);
+            attachReply(endpoint, reply);
+        },
+        [this, endpoint]() { onRequestDropped(endpoint); });
+    
+    if (m_pendingRequests.contains(requestId) && !m_pendingRequests[requestId].reply) {
+        m_pendingRequests[requestId].ticket = ticket;
+    }
+}
+
+void ApiClient::onRequestDropped(const QString& endpoint) {
+    ApiResult result;
+    result.errorMessage = "Request dropped";
+    
+    QList<int> waitingRequests = m_endpointToRequests.take(endpoint);
+    for (int requestId : waitingRequests) {
+        handleRequestComplete(requestId, result);
+    }
+}
+
 void ApiClient::handleRequestComplete(int requestId, const ApiResult& result) {
     if (!m_pendingRequests.contains(requestId)) {
         return;
@@ -377,6 +567,166 @@ void ApiClient::handleRequestComplete(int requestId, const ApiResult& result) {
     }
 }
 
+// ============================================================================
+// List Streaming
+// ============================================================================
+
+bool ApiClient::isStreamedList(RequestType type) {
+    // Lists that get big enough on large servers to be worth it
+    return type == RequestType::ServerMembers || type == RequestType::AllEmojis;
+}
+
+void ApiClient::onReplyReadyRead() {
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+    
+    int requestId = reply->property("requestId").toInt();
+    if (!m_pendingRequests.contains(requestId)) {
+        return;
+    }
+    
+    const PendingRequest& req = m_pendingRequests[requestId];
+    QSharedPointer<ListStream> stream = req.stream;
+    
+    if (!stream->active) {
+        // Only stream successful array bodies; anything else (error
+        // objects, unexpected shapes) stays in the reply for the normal path
+        int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        QByteArray head = reply->peek(64).trimmed();
+        if (head.isEmpty() && statusCode >= 200 && statusCode < 300) {
+            return;  // Wait for the first non-whitespace byte
+        }
+        if (statusCode < 200 || statusCode >= 300 || !head.startsWith('[')) {
+            disconnect(reply, &QNetworkReply::readyRead, this, &ApiClient::onReplyReadyRead);
+            return;
+        }
+        stream->active = true;
+    }
+    
+    feedListStream(req.endpoint, stream, reply->readAll());
+}
+
+int ApiClient::listStreamOwner(const QString& endpoint, const QSharedPointer<ListStream>& stream) const {
+    const QList<int> waitingRequests = m_endpointToRequests.value(endpoint);
+    for (int requestId : waitingRequests) {
+        if (m_pendingRequests.value(requestId).stream == stream) {
+            return requestId;
+        }
+    }
+    return -1;
+}
+
+void ApiClient::feedListStream(const QString& endpoint, const QSharedPointer<ListStream>& stream,
+                               const QByteArray& chunk) {
+    if (stream->failed) {
+        return;
+    }
+    stream->splitter.feed(chunk, stream->pending);
+    parseListBatch(endpoint, stream);
+}
+
+void ApiClient::parseListBatch(const QString& endpoint, const QSharedPointer<ListStream>& stream) {
+    if (stream->parsing) {
+        return;  // Picked up when the batch in flight comes back
+    }
+    
+    bool due = stream->pending.size() >= kStreamBatchItems
+            || (stream->finished && !stream->pending.isEmpty());
+    if (stream->failed || !due) {
+        if (stream->finished) {
+            completeListStream(endpoint, stream);
+        }
+        return;
+    }
+    
+    const QByteArrayList elements = stream->pending;
+    stream->pending.clear();
+    stream->parsing = true;
+    
+    runParseAsync([elements]() {
+        ApiResult parsed;
+        parsed.data["items"] = JsonArrayStream::parseElements(elements, &parsed.success);
+        return parsed;
+    }, [this, endpoint, stream](const ApiResult& parsed) {
+        stream->parsing = false;
+        
+        // Everyone waiting on it was cancelled in the meantime
+        int owner = listStreamOwner(endpoint, stream);
+        if (owner < 0) {
+            return;
+        }
+        
+        if (!parsed.success) {
+            stream->failed = true;
+        } else {
+            const QVariantList batch = parsed.data.value("items").toList();
+            stream->items.append(batch);
+            
+            // The full list still arrives with the regular signal once
+            // complete; every request waiting on the endpoint gets that, the
+            // batches only need to reach the caches once
+            bool last = stream->finished && stream->pending.isEmpty();
+            if (!last) {
+                const PendingRequest req = m_pendingRequests.value(owner);
+                switch (req.type) {
+                    case RequestType::ServerMembers:
+                        emit serverMembersBatchFetched(owner, req.context.value("serverId").toString(), batch);
+                        break;
+                    case RequestType::AllEmojis:
+                        emit allEmojisBatchFetched(owner, batch);
+                        break;
+                    default:
+                        break;
+                }
+                
+                // Receivers may have cancelled it
+                if (listStreamOwner(endpoint, stream) < 0) {
+                    return;
+                }
+            }
+        }
+        parseListBatch(endpoint, stream);
+    });
+}
+
+void ApiClient::finishListStream(const QString& endpoint, const QSharedPointer<ListStream>& stream,
+                                 QNetworkReply* reply) {
+    stream->statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    
+    if (reply->error() != QNetworkReply::NoError) {
+        ApiResult result;
+        result.statusCode = stream->statusCode;
+        result.errorMessage = extractErrorMessage(QVariantMap(), result.statusCode, reply->errorString());
+        onReplyParsed(endpoint, QString(), result);
+        return;
+    }
+    
+    stream->finished = true;
+    if (!stream->failed) {
+        stream->splitter.feed(reply->readAll(), stream->pending);
+    }
+    parseListBatch(endpoint, stream);
+}
+
+void ApiClient::completeListStream(const QString& endpoint, const QSharedPointer<ListStream>& stream) {
+    int owner = listStreamOwner(endpoint, stream);
+    if (owner < 0) {
+        return;
+    }
+    
+    ApiResult result;
+    result.statusCode = stream->statusCode;
+    if (stream->failed || stream->splitter.state() != JsonArrayStream::Done) {
+        qWarning() << "[ApiClient] Malformed list response for" << endpoint;
+        result.errorMessage = "Malformed response";
+    } else {
+        result.success = true;
+        result.data["items"] = stream->items;
+    }
+    onReplyParsed(endpoint, m_pendingRequests.value(owner).cacheKey, result,
+                  stream->etag, stream->lastModified);
+}
+
 // ============================================================================
 // Signal Emission (routes based on RequestType)
 // ============================================================================
@@ -7,14 +7,17 @@
 #include <QNetworkReply>
 #include <QPointer>
 #include <QMap>
+#include <QSet>
 #include <QDateTime>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QSharedPointer>
 #include <functional>
 
 #include "../apibase.h"
-
-class NetworkClient;
+#include "../responsestore.h"
+#include "../network/jsonarraystream.h"
+#include "../network/networkclient.h"
 
 /**
  * @brief Cached data entry with TTL support.
@@ -22,8 +25,13 @@ class NetworkClient;
 struct CacheEntry {
     QVariantMap data;
     QDateTime expiry;
+    QByteArray etag;          // Response ETag, sent back as If-None-Match
+    QByteArray lastModified;  // Response Last-Modified, sent back as If-Modified-Since
+    
+    bool restored = false;    // Loaded from disk and not refreshed since
     
     bool isValid() const { return QDateTime::currentDateTime() < expiry; }
+    bool canRevalidate() const { return !etag.isEmpty() || !lastModified.isEmpty(); }
 };
 
 /**
@@ -61,6 +69,22 @@ enum class RequestType {
     SystemInfo
 };
 
+/**
+ * @brief Incremental parse state for a list response read as it downloads.
+ */
+struct ListStream {
+    bool active = false;          // 2xx response whose body is a JSON array
+    bool failed = false;          // An element batch didn't parse
+    bool parsing = false;         // A batch is on the parse workers (one at a time, in order)
+    bool finished = false;        // Reply done; completes once parsing has caught up
+    JsonArrayStream splitter;
+    QByteArrayList pending;       // Elements split but not parsed yet
+    QVariantList items;           // Everything parsed so far
+    int statusCode = 0;           // Kept from the finished reply
+    QByteArray etag;
+    QByteArray lastModified;
+};
+
 /**
  * @brief Metadata for a pending request.
  */
@@ -70,6 +94,9 @@ struct PendingRequest {
     QString cacheKey;      // Key for caching result (empty = no cache)
     RequestType type;      // Type of request for signal routing
     QVariantMap context;   // Additional context (e.g., userId, serverId)
+    QSharedPointer<ListStream> stream;  // Set for streamed list endpoints
+    int ticket = 0;        // NetworkClient schedule ticket until the GET starts
+    NetworkClient::Priority priority = NetworkClient::Priority::Interactive;
 };
 
 /**
@@ -81,8 +108,17 @@ struct PendingRequest {
  * Design notes:
  * - Supports unlimited concurrent requests via request IDs
  * - Built-in caching with configurable TTL for efficiency on slow devices
+ * - Revalidation: cached entries carry ETag/Last-Modified, every GET for a
+ *   cached key is conditional, and a 304 just extends the entry's expiry
+ * - Persistence (optional): servers, channels, categories, roles and emoji
+ *   metadata are also kept on disk and loaded lazily per key; after a cold
+ *   start an expired copy is served once while a refresh runs
  * - Request IDs allow QML to track specific async operations
  * - Deduplication: identical in-flight requests share the same network call
+ * - Streaming: member and all-emoji lists are parsed while they download and
+ *   announced in batches (serverMembersBatchFetched, allEmojisBatchFetched)
+ *   before the usual *Fetched signal with the full list. Batches are parsed
+ *   on the ApiBase workers, one at a time so they arrive in order
  * - Modular: each API domain is in a separate .cpp file
  * 
  * Usage from QML:
@@ -105,7 +141,15 @@ public:
     // ========================================================================
     
     int getMyProfile();
-    int getProfile(const QString& userId, bool useCache = true);
+    
+    /**
+     * @brief Fetch a user's profile.
+     * @param priority Background suits lookups (UserProfileCache); pass
+     *        Interactive for a profile the user opened, which also promotes
+     *        a lookup of the same profile that is still queued
+     */
+    int getProfile(const QString& userId, bool useCache = true,
+                   NetworkClient::Priority priority = NetworkClient::Priority::Background);
     
     /**
      * @brief Update the current user's display name.
@@ -266,10 +310,12 @@ public:
      * @param channelId The channel ID
      * @param limit Maximum number of messages to fetch (default: 50)
      * @param before Fetch messages before this message ID (for pagination)
+     * @param around Fetch messages surrounding this message ID
      * @return Request ID for matching with messagesFetched signal
      */
     int getMessages(const QString& serverId, const QString& channelId, 
-                    int limit = 50, const QString& before = QString());
+                    int limit = 50, const QString& before = QString(),
+                    const QString& around = QString());
     
     /**
      * @brief Send a message to a channel.
@@ -368,6 +414,24 @@ public:
     void clearCacheFor(const QString& cacheKey);
     bool hasCachedData(const QString& cacheKey) const;
     
+    /// Keep persistable responses on disk under path (empty = memory only)
+    void setPersistentCacheDirectory(const QString& path);
+    
+    /// Size and age limits for the disk tier
+    void setPersistentCacheLimits(qint64 maxBytes, int maxAgeSeconds);
+    
+    /**
+     * @brief Supplies the body for a 304 on a key cached as validators only.
+     * 
+     * Latest message pages ("messages:" keys) keep just their ETag and
+     * Last-Modified here; the messages themselves live in MessageCache. The
+     * source gets the request's context and returns false if it can't
+     * rebuild the page, in which case the GET is repeated unconditionally.
+     */
+    using NotModifiedSource = std::function<bool(const QString& cacheKey, const QVariantMap& context,
+                                                 QVariantMap& outData)>;
+    void setNotModifiedSource(NotModifiedSource source) { m_notModifiedSource = source; }
+    
     // Legacy profile-specific cache methods
     bool hasCachedProfile(const QString& userId) const { return hasCachedData(userId); }
 
@@ -378,6 +442,15 @@ public:
     void cancelRequest(int requestId);
     void cancelAllRequests();
     bool isRequestPending(int requestId) const;
+    
+    /**
+     * @brief Drop background GETs still waiting for a connection slot.
+     * 
+     * For when the user moves on and queued profile/emoji lookups are no
+     * longer for what's on screen. Their requests fail with "Request
+     * dropped", so callers clear their in-flight state as for any error.
+     */
+    void cancelQueuedBackgroundRequests();
 
 signals:
     // ========================================================================
@@ -422,6 +495,9 @@ signals:
     // Server Members Signals
     // ========================================================================
     void serverMembersFetched(int requestId, const QString& serverId, const QVariantList& members);
+    /// Part of a member list that is still downloading; serverMembersFetched follows.
+    /// Sent once per download, with the id of the request that owns it.
+    void serverMembersBatchFetched(int requestId, const QString& serverId, const QVariantList& members);
     void serverMembersFetchFailed(int requestId, const QString& serverId, const QString& error);
     
     // ========================================================================
@@ -440,6 +516,9 @@ signals:
     // All Emojis Signals (emojis from all servers user is member of)
     // ========================================================================
     void allEmojisFetched(int requestId, const QVariantList& emojis);
+    /// Part of the emoji list that is still downloading; allEmojisFetched follows.
+    /// Sent once per download, with the id of the request that owns it.
+    void allEmojisBatchFetched(int requestId, const QVariantList& emojis);
     void allEmojisFetchFailed(int requestId, const QString& error);
     
     // ========================================================================
@@ -508,6 +587,15 @@ protected:
                         const QString& cacheKey = QString(), bool useCache = true,
                         const QVariantMap& context = {});
     
+    /**
+     * @brief startGetRequest() with the caller choosing the scheduling class
+     * instead of the default for the request type. A request deduplicated
+     * onto a GET that is still queued raises it to `priority`.
+     */
+    int startGetRequest(RequestType type, NetworkClient::Priority priority,
+                        const QString& endpoint, const QString& cacheKey = QString(),
+                        bool useCache = true, const QVariantMap& context = {});
+    
     /**
      * @brief Start a POST request.
      * @param type The request type for signal routing
@@ -568,13 +656,26 @@ protected:
     
     // Cache helpers
     bool checkCache(const QString& cacheKey, QVariantMap& outData) const;
-    void updateCache(const QString& cacheKey, const QVariantMap& data);
+    void updateCache(const QString& cacheKey, const QVariantMap& data,
+                     const QByteArray& etag = QByteArray(),
+                     const QByteArray& lastModified = QByteArray());
+    
+    /// If-None-Match / If-Modified-Since for a cached entry (empty if none)
+    QVariantMap conditionalHeaders(const QString& cacheKey) const;
+    
+    /// Handle a 304: extend the entry's expiry and return its data
+    /// (from the NotModifiedSource for validator-only keys)
+    bool revalidateCache(const QString& cacheKey, const QVariantMap& context, QVariantMap& outData);
+    
+    /// An expired entry restored from disk, served once after a cold start
+    bool takeRestoredCache(const QString& cacheKey, QVariantMap& outData);
     
     // Request ID generator
     int generateRequestId() { return m_nextRequestId++; }
 
 private slots:
     void onReplyFinished();
+    void onReplyReadyRead();
 
 private:
     NetworkClient* m_networkClient;
@@ -585,12 +686,53 @@ private:
     QMap<int, PendingRequest> m_pendingRequests;
     QMap<QString, QList<int>> m_endpointToRequests;
     
-    // Generic cache: cacheKey -> CacheEntry
-    QMap<QString, CacheEntry> m_cache;
+    // Generic cache: cacheKey -> CacheEntry. Filled from the disk tier on
+    // first lookup of a key, hence mutable for the const lookups.
+    mutable QMap<QString, CacheEntry> m_cache;
     int m_cacheTTLSeconds = 60;
     
+    // Disk tier
+    mutable ResponseStore m_store;
+    mutable QSet<QString> m_storeChecked;  // Keys already looked up on disk
+    
+    /// Memory entry for a key, loading it from disk on first use (or null)
+    CacheEntry* cacheEntry(const QString& cacheKey) const;
+    static bool isPersistentKey(const QString& cacheKey);
+    /// Keys whose entries hold validators but no body (see NotModifiedSource)
+    static bool isValidatorOnlyKey(const QString& cacheKey);
+    NotModifiedSource m_notModifiedSource;
+    void persistCacheEntry(const QString& cacheKey, const CacheEntry& entry);
+    
     // Internal helpers
     void cleanupRequest(int requestId);
+    
+    /// Hook a dispatched GET up to the first request still waiting on its endpoint
+    void attachReply(const QString& endpoint, QNetworkReply* reply);
+    
+    /// Fetch an endpoint again without conditional headers, for a 304 whose
+    /// cached copy went away while the request was out
+    void retryUnconditional(int requestId);
+    
+    /// Fail every request waiting on an endpoint whose GET was dropped unsent
+    void onRequestDropped(const QString& endpoint);
+    
+    /// Second half of onReplyFinished(), once the body has been parsed.
+    /// Requests cancelled in between are skipped by handleRequestComplete().
+    void onReplyParsed(const QString& endpoint, const QString& cacheKey, const ApiResult& result,
+                       const QByteArray& etag = QByteArray(),
+                       const QByteArray& lastModified = QByteArray());
+    
+    // List streaming
+    static bool isStreamedList(RequestType type);
+    /// Request currently holding `stream` for `endpoint`, or -1 once nobody does
+    int listStreamOwner(const QString& endpoint, const QSharedPointer<ListStream>& stream) const;
+    void feedListStream(const QString& endpoint, const QSharedPointer<ListStream>& stream,
+                        const QByteArray& chunk);
+    void parseListBatch(const QString& endpoint, const QSharedPointer<ListStream>& stream);
+    void finishListStream(const QString& endpoint, const QSharedPointer<ListStream>& stream,
+                          QNetworkReply* reply);
+    void completeListStream(const QString& endpoint, const QSharedPointer<ListStream>& stream);
+    
     void emitSuccess(int requestId, const PendingRequest& req, const QVariantMap& data);
     void emitFailure(int requestId, const PendingRequest& req, const QString& error);
 };
@@ -7,47 +7,181 @@
 
 void ApiClient::clearCache() {
     m_cache.clear();
+    m_storeChecked.clear();
+    m_store.clear();
     qDebug() << "[ApiClient] Cache cleared";
 }
 
 void ApiClient::clearCacheFor(const QString& cacheKey) {
     m_cache.remove(cacheKey);
+    m_storeChecked.insert(cacheKey);  // Nothing left on disk either
+    m_store.remove(cacheKey);
     qDebug() << "[ApiClient] Cache cleared for:" << cacheKey;
 }
 
 bool ApiClient::hasCachedData(const QString& cacheKey) const {
-    if (!m_cache.contains(cacheKey)) {
-        return false;
-    }
-    return m_cache[cacheKey].isValid();
+    const CacheEntry* entry = cacheEntry(cacheKey);
+    return entry && entry->isValid();
 }
 
-bool ApiClient::checkCache(const QString& cacheKey, QVariantMap& outData) const {
+void ApiClient::setPersistentCacheDirectory(const QString& path) {
+    m_store.setDirectory(path);
+    m_storeChecked.clear();
+    qDebug() << "[ApiClient] Persistent cache" << (path.isEmpty() ? "disabled" : path);
+}
+
+void ApiClient::setPersistentCacheLimits(qint64 maxBytes, int maxAgeSeconds) {
+    m_store.setLimits(maxBytes, maxAgeSeconds);
+}
+
+CacheEntry* ApiClient::cacheEntry(const QString& cacheKey) const {
     if (cacheKey.isEmpty()) {
-        return false;
+        return nullptr;
+    }
+    
+    auto it = m_cache.find(cacheKey);
+    if (it != m_cache.end()) {
+        return &it.value();
+    }
+    
+    // Each key is looked up on disk at most once per session
+    if (!m_store.isEnabled() || !isPersistentKey(cacheKey) || m_storeChecked.contains(cacheKey)) {
+        return nullptr;
+    }
+    m_storeChecked.insert(cacheKey);
+    
+    ResponseStore::Entry stored;
+    if (!m_store.load(cacheKey, stored)) {
+        return nullptr;
+    }
+    
+    CacheEntry entry;
+    entry.data = stored.data;
+    entry.expiry = stored.storedAt.toLocalTime().addSecs(m_cacheTTLSeconds);
+    entry.etag = stored.etag;
+    entry.lastModified = stored.lastModified;
+    entry.restored = true;
+    qDebug() << "[ApiClient] Restored from disk:" << cacheKey;
+    return &m_cache.insert(cacheKey, entry).value();
+}
+
+bool ApiClient::isPersistentKey(const QString& cacheKey) {
+    // What a cold start needs before the network answers. Profiles and
+    // members are refetched on demand; messages have their own store.
+    static const char* const prefixes[] = {
+        "servers:", "channels:", "categories:", "roles:", "emojis:", "emoji:"
+    };
+    for (const char* prefix : prefixes) {
+        if (cacheKey.startsWith(QLatin1String(prefix))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ApiClient::isValidatorOnlyKey(const QString& cacheKey) {
+    // Full pages would sit here unbounded next to MessageCache's own copy
+    return cacheKey.startsWith(QLatin1String("messages:"));
+}
+
+void ApiClient::persistCacheEntry(const QString& cacheKey, const CacheEntry& entry) {
+    if (!m_store.isEnabled() || !isPersistentKey(cacheKey)) {
+        return;
     }
     
-    if (!m_cache.contains(cacheKey)) {
+    ResponseStore::Entry stored;
+    stored.data = entry.data;
+    stored.storedAt = QDateTime::currentDateTimeUtc();
+    stored.etag = entry.etag;
+    stored.lastModified = entry.lastModified;
+    m_store.save(cacheKey, stored);
+    m_storeChecked.insert(cacheKey);
+}
+
+bool ApiClient::checkCache(const QString& cacheKey, QVariantMap& outData) const {
+    const CacheEntry* entry = cacheEntry(cacheKey);
+    if (!entry || !entry->isValid()) {
         return false;
     }
     
-    const CacheEntry& entry = m_cache[cacheKey];
-    if (!entry.isValid()) {
+    outData = entry->data;
+    return true;
+}
+
+bool ApiClient::takeRestoredCache(const QString& cacheKey, QVariantMap& outData) {
+    CacheEntry* entry = cacheEntry(cacheKey);
+    if (!entry || !entry->restored) {
         return false;
     }
     
-    outData = entry.data;
+    // Once only: from here on the entry is refreshed like any other
+    entry->restored = false;
+    outData = entry->data;
     return true;
 }
 
-void ApiClient::updateCache(const QString& cacheKey, const QVariantMap& data) {
+void ApiClient::updateCache(const QString& cacheKey, const QVariantMap& data,
+                            const QByteArray& etag, const QByteArray& lastModified) {
     if (cacheKey.isEmpty()) {
         return;
     }
     
     CacheEntry entry;
-    entry.data = data;
+    if (isValidatorOnlyKey(cacheKey)) {
+        if (etag.isEmpty() && lastModified.isEmpty()) {
+            m_cache.remove(cacheKey);  // Nothing to revalidate with
+            return;
+        }
+    } else {
+        entry.data = data;
+    }
     entry.expiry = QDateTime::currentDateTime().addSecs(m_cacheTTLSeconds);
+    entry.etag = etag;
+    entry.lastModified = lastModified;
     m_cache[cacheKey] = entry;
+    persistCacheEntry(cacheKey, entry);
     qDebug() << "[ApiClient] Cached data for:" << cacheKey;
-}
\ No newline at end of file
+}
+
+QVariantMap ApiClient::conditionalHeaders(const QString& cacheKey) const {
+    QVariantMap headers;
+    
+    // Expired entries are exactly the ones worth revalidating
+    const CacheEntry* entry = cacheEntry(cacheKey);
+    if (!entry || !entry->canRevalidate()) {
+        return headers;
+    }
+    
+    if (!entry->etag.isEmpty()) {
+        headers["If-None-Match"] = QString::fromLatin1(entry->etag);
+    }
+    if (!entry->lastModified.isEmpty()) {
+        headers["If-Modified-Since"] = QString::fromLatin1(entry->lastModified);
+    }
+    return headers;
+}
+
+bool ApiClient::revalidateCache(const QString& cacheKey, const QVariantMap& context, QVariantMap& outData) {
+    CacheEntry* entry = cacheEntry(cacheKey);
+    if (!entry) {
+        return false;
+    }
+    
+    if (isValidatorOnlyKey(cacheKey)) {
+        if (!m_notModifiedSource || !m_notModifiedSource(cacheKey, context, outData)) {
+            return false;
+        }
+    } else {
+        outData = entry->data;
+    }
+    
+    entry->expiry = QDateTime::currentDateTime().addSecs(m_cacheTTLSeconds);
+    entry->restored = false;
+    // Restart its age on disk; the body is only rewritten if the file is gone
+    if (m_store.isEnabled() && isPersistentKey(cacheKey)
+            && !m_store.touch(cacheKey, QDateTime::currentDateTimeUtc())) {
+        persistCacheEntry(cacheKey, *entry);
+    }
+    qDebug() << "[ApiClient] Not modified, revalidated:" << cacheKey;
+    return true;
+}
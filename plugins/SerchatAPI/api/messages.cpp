@@ -9,7 +9,7 @@
 // ============================================================================
 
 int ApiClient::getMessages(const QString& serverId, const QString& channelId, 
-                           int limit, const QString& before) {
+                           int limit, const QString& before, const QString& around) {
     if (serverId.isEmpty() || channelId.isEmpty()) {
         int requestId = generateRequestId();
         QMetaObject::invokeMethod(this, [this, requestId, serverId, channelId]() {
@@ -29,13 +29,22 @@ int ApiClient::getMessages(const QString& serverId, const QString& channelId,
     if (!before.isEmpty()) {
         endpoint += QStringLiteral("&before=%1").arg(before);
     }
+    if (!around.isEmpty()) {
+        endpoint += QStringLiteral("&around=%1").arg(around);
+    }
     
-    // Don't cache messages - they change frequently
-    QString cacheKey;  // Empty = no caching
+    // Messages change too often to be served from cache, but the latest
+    // page's validators are kept so refetching it can be a conditional
+    // request; a 304 is answered from MessageCache (see NotModifiedSource)
+    QString cacheKey;
+    if (before.isEmpty() && around.isEmpty()) {
+        cacheKey = QStringLiteral("messages:%1:%2:%3").arg(serverId, channelId, QString::number(limit));
+    }
     
     QVariantMap context;
     context["serverId"] = serverId;
     context["channelId"] = channelId;
+    context["limit"] = limit;
     
     return startGetRequest(RequestType::Messages, endpoint, cacheKey, false, context);
 }
@@ -130,7 +139,8 @@ int ApiClient::getDMMessages(const QString& userId, int limit, const QString& be
         endpoint += QStringLiteral("&before=%1").arg(before);
     }
     
-    // Don't cache DM messages - they change frequently
+    // Don't cache DM messages - they change frequently, and there's no
+    // local copy a 304 could be answered from
     QString cacheKey;  // Empty = no caching
     
     QVariantMap context;
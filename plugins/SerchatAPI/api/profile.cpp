@@ -6,10 +6,10 @@
 // ============================================================================
 
 int ApiClient::getMyProfile() {
-    return getProfile("me", true);
+    return getProfile("me", true, NetworkClient::Priority::Interactive);
 }
 
-int ApiClient::getProfile(const QString& userId, bool useCache) {
+int ApiClient::getProfile(const QString& userId, bool useCache, NetworkClient::Priority priority) {
     QString cacheKey = QStringLiteral("profile:%1").arg(userId);
     QString endpoint = (userId == "me") 
         ? "/api/v1/profile/me" 
@@ -17,7 +17,7 @@ int ApiClient::getProfile(const QString& userId, bool useCache) {
     
     RequestType type = (userId == "me") ? RequestType::MyProfile : RequestType::Profile;
     
-    return startGetRequest(type, endpoint, cacheKey, useCache);
+    return startGetRequest(type, priority, endpoint, cacheKey, useCache);
 }
 
 int ApiClient::updateDisplayName(const QString& displayName) {
@@ -4,8 +4,45 @@
 #include <QJsonArray>
 #include <QUrlQuery>
 #include <QDebug>
+#include <QRunnable>
+
+namespace {
+// Bodies below this are parsed inline; the worker round trip isn't worth it
+const int kInlineParseBytes = 16 * 1024;
+
+// Leave the remaining cores to rendering
+const int kMaxParseThreads = 2;
+
+class ParseTask : public QRunnable {
+public:
+    ParseTask(std::function<ApiResult()> parse, QObject* receiver,
+              std::function<void(const ApiResult&)> done)
+        : m_parse(parse), m_receiver(receiver), m_done(done) {}
+
+    void run() override {
+        ApiResult result = m_parse();
+        std::function<void(const ApiResult&)> done = m_done;
+        QMetaObject::invokeMethod(m_receiver, [done, result]() {
+            done(result);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    std::function<ApiResult()> m_parse;
+    QObject* m_receiver;
+    std::function<void(const ApiResult&)> m_done;
+};
+}
+
+ApiBase::ApiBase(QObject* parent) : QObject(parent) {
+    m_parsePool.setMaxThreadCount(kMaxParseThreads);
+}
 
-ApiBase::ApiBase(QObject* parent) : QObject(parent) {}
+ApiBase::~ApiBase() {
+    // Running tasks post back to us; once they are done, ~QObject drops
+    // whatever they posted
+    m_parsePool.waitForDone();
+}
 
 QUrl ApiBase::buildUrl(const QString& baseUrl, const QString& endpoint, const QVariantMap& params) const {
     // Ensure proper URL joining (handle trailing/leading slashes)
@@ -71,14 +108,45 @@ ApiResult ApiBase::handleReply(QNetworkReply* reply) const {
         return result;
     }
 
-    result.statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-    QByteArray responseData = reply->readAll();
-    result.data = parseJsonResponse(responseData);
+    return buildResult(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(),
+                       reply->readAll(), reply->error(), reply->errorString());
+}
+
+void ApiBase::handleReplyAsync(QNetworkReply* reply, std::function<void(const ApiResult&)> done) {
+    if (!reply) {
+        done(handleReply(reply));
+        return;
+    }
+
+    int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    QByteArray body = reply->readAll();
+    QNetworkReply::NetworkError error = reply->error();
+    QString errorString = reply->errorString();
+
+    if (body.size() < kInlineParseBytes) {
+        done(buildResult(statusCode, body, error, errorString));
+        return;
+    }
+
+    runParseAsync([this, statusCode, body, error, errorString]() {
+        return buildResult(statusCode, body, error, errorString);
+    }, done);
+}
+
+void ApiBase::runParseAsync(std::function<ApiResult()> parse, std::function<void(const ApiResult&)> done) {
+    m_parsePool.start(new ParseTask(parse, this, done));
+}
+
+ApiResult ApiBase::buildResult(int statusCode, const QByteArray& body,
+                               QNetworkReply::NetworkError error, const QString& errorString) const {
+    ApiResult result;
+    result.statusCode = statusCode;
+    result.data = parseJsonResponse(body);
 
     // Check for network-level errors
-    if (reply->error() != QNetworkReply::NoError) {
+    if (error != QNetworkReply::NoError) {
         result.success = false;
-        result.errorMessage = extractErrorMessage(result.data, result.statusCode, reply->errorString());
+        result.errorMessage = extractErrorMessage(result.data, result.statusCode, errorString);
         return result;
     }
 
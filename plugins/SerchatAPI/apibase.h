@@ -5,6 +5,8 @@
 #include <QUrl>
 #include <QVariantMap>
 #include <QNetworkReply>
+#include <QThreadPool>
+#include <functional>
 
 /**
  * @brief Represents the result of an API call.
@@ -36,7 +38,7 @@ class ApiBase : public QObject {
 
 public:
     explicit ApiBase(QObject* parent = nullptr);
-    virtual ~ApiBase() = default;
+    virtual ~ApiBase();
 
 protected:
     /// Build a URL with optional query parameters
@@ -62,12 +64,41 @@ protected:
      */
     ApiResult handleReply(QNetworkReply* reply) const;
 
+    /**
+     * @brief handleReply() with the JSON decode moved off the GUI thread.
+     * 
+     * The body and status are read from the reply right away, so it can be
+     * deleted as soon as this returns. Large bodies (member lists, emoji
+     * lists) are parsed on a worker thread; small ones inline, where the
+     * thread hop would cost more than the parse. Either way `done` runs on
+     * this object's thread with the finished result - never after the
+     * object is destroyed.
+     */
+    void handleReplyAsync(QNetworkReply* reply, std::function<void(const ApiResult&)> done);
+
+    /**
+     * @brief Run `parse` on the parse workers and `done` back on this thread.
+     * 
+     * `parse` must not touch this object's state. As with handleReplyAsync(),
+     * `done` never runs after the object is destroyed; tasks may finish in
+     * any order.
+     */
+    void runParseAsync(std::function<ApiResult()> parse, std::function<void(const ApiResult&)> done);
+
     /**
      * @brief Extract error message from response or generate default.
      * 
      * Looks for common error fields: "error", "message", "detail"
      */
     QString extractErrorMessage(const QVariantMap& response, int statusCode, const QString& networkError = {}) const;
+
+private:
+    /// Turn a reply's status and body into an ApiResult (thread-safe)
+    ApiResult buildResult(int statusCode, const QByteArray& body,
+                          QNetworkReply::NetworkError error, const QString& errorString) const;
+
+    // Response parsing workers (waited for on destruction)
+    QThreadPool m_parsePool;
 };
 
 #endif // APIBASE_H
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "cachedmessage.h"
+#include <QDateTime>
+
+namespace {
+// Per-allocation bookkeeping we charge for containers and nodes
+const int kNodeOverhead = 32;
+
+int stringSize(const QString& str) {
+    return str.isEmpty() ? 0 : kNodeOverhead + str.size() * int(sizeof(QChar));
+}
+
+int variantSize(const QVariant& value) {
+    switch (value.type()) {
+    case QVariant::String:
+        return int(sizeof(QVariant)) + stringSize(value.toString());
+    case QVariant::Map: {
+        const QVariantMap map = value.toMap();
+        int size = int(sizeof(QVariant)) + kNodeOverhead;
+        for (QVariantMap::const_iterator it = map.constBegin(); it != map.constEnd(); ++it) {
+            size += kNodeOverhead + stringSize(it.key()) + variantSize(it.value());
+        }
+        return size;
+    }
+    case QVariant::List: {
+        const QVariantList list = value.toList();
+        int size = int(sizeof(QVariant)) + kNodeOverhead;
+        for (const QVariant& item : list) {
+            size += variantSize(item);
+        }
+        return size;
+    }
+    default:
+        return int(sizeof(QVariant));
+    }
+}
+}
+
+QString CachedMessage::extractId(const QVariantMap& message) {
+    // Handle different ID field patterns:
+    // - "id" / "_id" from REST API / MongoDB
+    // - "messageId" from WebSocket API
+    if (message.contains("_id")) {
+        return message["_id"].toString();
+    }
+    if (message.contains("id")) {
+        return message["id"].toString();
+    }
+    if (message.contains("messageId")) {
+        return message["messageId"].toString();
+    }
+    return QString();
+}
+
+qint64 CachedMessage::extractTimestamp(const QVariantMap& message) {
+    // Try different timestamp field names
+    QVariant ts;
+    if (message.contains("createdAt")) {
+        ts = message["createdAt"];
+    } else if (message.contains("timestamp")) {
+        ts = message["timestamp"];
+    } else if (message.contains("created_at")) {
+        ts = message["created_at"];
+    }
+
+    QDateTime dt;
+    if (ts.type() == QVariant::DateTime) {
+        dt = ts.toDateTime();
+    } else if (ts.type() == QVariant::String) {
+        dt = QDateTime::fromString(ts.toString(), Qt::ISODate);
+    } else if (ts.type() == QVariant::LongLong || ts.type() == QVariant::Double) {
+        return ts.toLongLong();
+    }
+
+    return dt.isValid() ? dt.toMSecsSinceEpoch() : 0;
+}
+
+CachedMessage CachedMessage::fromVariantMap(const QVariantMap& message) {
+    CachedMessage msg;
+    msg.id = extractId(message);
+    msg.createdAt = extractTimestamp(message);
+    msg.extra = message;
+
+    // Move the typed fields out of the pass-through map so they are
+    // stored only once
+    msg.extra.remove("_id");
+
+    if (message.contains("senderId")) {
+        msg.senderId = msg.extra.take("senderId").toString();
+    }
+    if (message.contains("channelId")) {
+        msg.channelId = msg.extra.take("channelId").toString();
+    }
+    if (message.contains("text")) {
+        msg.text = msg.extra.take("text").toString();
+        msg.setFlag(HasText);
+    }
+    if (message.contains("reactions")) {
+        msg.reactions = msg.extra.take("reactions").toList();
+        msg.setFlag(HasReactions);
+    }
+    if (message.value("isEdited").type() == QVariant::Bool) {
+        msg.setFlag(Edited, msg.extra.take("isEdited").toBool());
+    }
+
+    // Only drop the original createdAt string if it parsed cleanly;
+    // otherwise keep it verbatim so nothing is lost
+    if (msg.createdAt != 0 && message.value("createdAt").type() == QVariant::String) {
+        msg.extra.remove("createdAt");
+        msg.setFlag(HasCreatedAt);
+    }
+
+    return msg;
+}
+
+QVariantMap CachedMessage::toVariantMap() const {
+    QVariantMap map = extra;
+
+    if (!id.isEmpty()) {
+        map["_id"] = id;
+    }
+    if (!senderId.isEmpty()) {
+        map["senderId"] = senderId;
+    }
+    if (!channelId.isEmpty()) {
+        map["channelId"] = channelId;
+    }
+    if (hasFlag(HasText)) {
+        map["text"] = text;
+    }
+    if (hasFlag(HasReactions)) {
+        map["reactions"] = reactions;
+    }
+    if (hasFlag(Edited)) {
+        map["isEdited"] = true;
+    }
+    if (hasFlag(HasCreatedAt)) {
+        map["createdAt"] = QDateTime::fromMSecsSinceEpoch(createdAt, Qt::UTC)
+                               .toString(Qt::ISODateWithMs);
+    }
+
+    return map;
+}
+
+bool CachedMessage::sameContent(const CachedMessage& other) const {
+    // Cheap typed fields first; the QVariant comparisons only run when
+    // everything else already matches
+    return flags == other.flags
+        && createdAt == other.createdAt
+        && text == other.text
+        && senderId == other.senderId
+        && reactions == other.reactions
+        && extra == other.extra;
+}
+
+int CachedMessage::approximateSize() const {
+    return int(sizeof(CachedMessage))
+        + stringSize(id) + stringSize(senderId) + stringSize(channelId) + stringSize(text)
+        + variantSize(reactions) + variantSize(extra);
+}
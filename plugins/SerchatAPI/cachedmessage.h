@@ -0,0 +1,85 @@
+#ifndef CACHEDMESSAGE_H
+#define CACHEDMESSAGE_H
+
+#include <QString>
+#include <QVariantMap>
+#include <QVariantList>
+#include <QVector>
+
+/**
+ * @brief Typed message record used by MessageCache.
+ *
+ * The fields the cache works with (id, sender, channel, timestamp, text,
+ * flags, reactions) are stored as plain members so sorting, trimming and
+ * lookups never unbox QVariants or re-parse ISO timestamps.
+ *
+ * Anything else the server sends (attachments, replies, edit metadata, ...)
+ * is kept untouched in `extra`, so the QVariantMap handed back to QML via
+ * toVariantMap() carries the same information that came in.
+ */
+struct CachedMessage {
+    enum Flag {
+        HasCreatedAt = 0x01,  // createdAt was present and parsed
+        HasText      = 0x02,  // text field was present
+        HasReactions = 0x04,  // reactions field was present
+        Edited       = 0x08   // isEdited == true
+    };
+
+    QString id;
+    QString senderId;
+    QString channelId;
+    qint64 createdAt = 0;     // Milliseconds since epoch (0 if unknown)
+    QString text;
+    quint32 flags = 0;
+    QVariantList reactions;   // Implicitly shared, cheap to copy
+    QVariantMap extra;        // Remaining fields, passed through as-is
+
+    bool hasFlag(Flag flag) const { return (flags & flag) != 0; }
+    void setFlag(Flag flag, bool on = true) {
+        if (on) {
+            flags |= flag;
+        } else {
+            flags &= ~static_cast<quint32>(flag);
+        }
+    }
+
+    /**
+     * @brief Build a typed record from an API/socket message map.
+     * Timestamps are parsed once here and never again.
+     */
+    static CachedMessage fromVariantMap(const QVariantMap& message);
+
+    /**
+     * @brief Convert back to the QVariantMap shape QML expects.
+     */
+    QVariantMap toVariantMap() const;
+
+    /**
+     * @brief True if both records carry the same content (text, flags,
+     * reactions and pass-through fields). Used to spot server-side edits.
+     */
+    bool sameContent(const CachedMessage& other) const;
+    
+    /**
+     * @brief Rough heap footprint in bytes, for cache memory budgeting.
+     * Counts string payloads and nested variants; not exact, but stable
+     * enough to compare channels against each other.
+     */
+    int approximateSize() const;
+    
+    /**
+     * @brief Extract the message ID ("_id", "id" or "messageId").
+     */
+    static QString extractId(const QVariantMap& message);
+
+    /**
+     * @brief Extract the creation timestamp in ms since epoch (0 if missing/invalid).
+     */
+    static qint64 extractTimestamp(const QVariantMap& message);
+};
+
+Q_DECLARE_TYPEINFO(CachedMessage, Q_MOVABLE_TYPE);
+
+typedef QVector<CachedMessage> CachedMessageList;
+
+#endif // CACHEDMESSAGE_H
@@ -15,11 +15,6 @@ void ChannelCache::setTTL(int seconds) {
     m_ttlSeconds = seconds;
 }
 
-void ChannelCache::bumpVersion() {
-    m_version++;
-    emit versionChanged();
-}
-
 QString ChannelCache::extractId(const QVariantMap& item) const {
     // Handle both "id" and "_id" patterns
     if (item.contains("id")) {
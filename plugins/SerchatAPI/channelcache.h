@@ -10,6 +10,8 @@
 #include <QString>
 #include <QTimer>
 
+#include "versionbatcher.h"
+
 class ApiClient;
 
 /**
@@ -95,7 +97,11 @@ public:
     /**
      * @brief Get version counter for QML binding invalidation.
      */
-    int version() const { return m_version; }
+    int version() const { return m_versions.version(); }
+    
+    /// Coalesce versionChanged() until endBatch() (see VersionBatcher)
+    void beginBatch() { m_versions.begin(); }
+    void endBatch() { if (m_versions.end()) emit versionChanged(); }
     
     // ========================================================================
     // C++ methods for cache management
@@ -202,9 +208,9 @@ private:
     // Configuration
     ApiClient* m_apiClient = nullptr;
     int m_ttlSeconds = 300;  // 5 minutes default
-    int m_version = 0;
+    VersionBatcher m_versions;
     
-    void bumpVersion();
+    void bumpVersion() { if (m_versions.bump()) emit versionChanged(); }
     QString extractId(const QVariantMap& item) const;
 };
 
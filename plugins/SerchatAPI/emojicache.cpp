@@ -287,12 +287,6 @@ void EmojiCache::onEmojiFetchFailed(int requestId, const QString& emojiId, const
 // Private helpers
 // ============================================================================
 
-void EmojiCache::bumpVersion()
-{
-    m_version++;
-    emit versionChanged();
-}
-
 QString EmojiCache::extractId(const QVariantMap& emoji)
 {
     // Try common ID field names
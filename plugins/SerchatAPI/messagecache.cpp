@@ -2,10 +2,35 @@
 #include "api/apiclient.h"
 #include <QDebug>
 #include <algorithm>
+#include <iterator>
+
+namespace {
+// Trailing cached messages re-fetched by a delta sync so that edits and
+// deletes that happened while disconnected are picked up
+const int kDeltaOverlap = 10;
+
+// Recently viewed channels (besides the active one) kept safe from eviction
+const int kPinnedRecentChannels = 3;
+}
 
 MessageCache::MessageCache(QObject *parent)
     : QObject(parent)
+    , m_evictTimer(new QTimer(this))
+    , m_flushTimer(new QTimer(this))
 {
+    // Budget check runs once per event loop pass, not per mutation
+    m_evictTimer->setSingleShot(true);
+    m_evictTimer->setInterval(0);
+    connect(m_evictTimer, &QTimer::timeout, this, &MessageCache::evictIfNeeded);
+    
+    // Coalesce bursts of socket updates into one disk write per channel
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(2000);
+    connect(m_flushTimer, &QTimer::timeout, this, &MessageCache::flush);
+}
+
+MessageCache::~MessageCache() {
+    flush();
 }
 
 void MessageCache::setApiClient(ApiClient* apiClient) {
@@ -20,78 +45,349 @@ void MessageCache::setMaxMessagesPerChannel(int count) {
     m_maxMessagesPerChannel = count;
 }
 
-void MessageCache::bumpVersion() {
-    m_version++;
-    emit versionChanged();
+void MessageCache::setStorageDirectory(const QString& path) {
+    m_store.setDirectory(path);
+    qDebug() << "MessageCache: Persistent store" << (path.isEmpty() ? "disabled" : path);
+}
+
+void MessageCache::setMemoryBudget(qint64 maxBytes, int maxChannels) {
+    m_maxBytes = maxBytes;
+    m_maxChannels = maxChannels;
+    scheduleEviction();
 }
 
-QString MessageCache::extractId(const QVariantMap& item) const {
-    // Handle different ID field patterns:
-    // - "id" / "_id" from REST API / MongoDB
-    // - "messageId" from WebSocket API
-    if (item.contains("_id")) {
-        return item["_id"].toString();
+void MessageCache::sortMessages(CachedMessageList& messages) {
+    // Order by timestamp (oldest first for chat display). Timestamps were
+    // parsed at ingest, so every comparison here is a plain integer compare.
+    //
+    // Pages from the API are already ordered - oldest-first from the REST
+    // endpoint, newest-first after SerchatAPI reverses them for the UI - so
+    // detect those cases in O(n) before falling back to a real sort.
+    if (std::is_sorted(messages.constBegin(), messages.constEnd(), &MessageCache::olderThan)) {
+        return;
     }
-    if (item.contains("id")) {
-        return item["id"].toString();
+    if (std::is_sorted(messages.constBegin(), messages.constEnd(), &MessageCache::newerThan)) {
+        std::reverse(messages.begin(), messages.end());
+        return;
     }
-    if (item.contains("messageId")) {
-        return item["messageId"].toString();
+    std::stable_sort(messages.begin(), messages.end(), &MessageCache::olderThan);
+}
+
+CachedMessageList MessageCache::mergeSorted(const CachedMessageList& a, const CachedMessageList& b) {
+    // Linear merge of two already-ordered lists
+    CachedMessageList merged;
+    merged.reserve(a.size() + b.size());
+    std::merge(a.constBegin(), a.constEnd(), b.constBegin(), b.constEnd(),
+               std::back_inserter(merged), &MessageCache::olderThan);
+    return merged;
+}
+
+void MessageCache::trimMessages(CacheEntry& entry) {
+    // Keep only the most recent messages if over limit
+    if (entry.messages.size() > m_maxMessagesPerChannel) {
+        // Remove oldest messages (from the beginning). Only their index
+        // entries go away; the survivors keep their sequence numbers.
+        int toRemove = entry.messages.size() - m_maxMessagesPerChannel;
+        for (int i = 0; i < toRemove; ++i) {
+            entry.idIndex.remove(entry.messages.at(i).id);
+        }
+        entry.messages.remove(0, toRemove);
+        entry.baseSeq += toRemove;
+        entry.hasMoreHistory = true;  // Since we trimmed, there are more to load
     }
-    return QString();
 }
 
-QDateTime MessageCache::extractTimestamp(const QVariantMap& message) const {
-    // Try different timestamp field names
-    QVariant ts;
-    if (message.contains("createdAt")) {
-        ts = message["createdAt"];
-    } else if (message.contains("timestamp")) {
-        ts = message["timestamp"];
-    } else if (message.contains("created_at")) {
-        ts = message["created_at"];
+int MessageCache::findMessageIndex(const CacheEntry& entry, const QString& messageId) const {
+    QHash<QString, qint64>::const_iterator it = entry.idIndex.constFind(messageId);
+    if (it == entry.idIndex.constEnd()) {
+        return -1;
     }
+    return static_cast<int>(it.value() - entry.baseSeq);
+}
+
+void MessageCache::rebuildIndex(CacheEntry& entry) {
+    // Full rebuild after bulk changes. Also drops records without an ID
+    // and duplicate IDs so the index stays one-to-one with the vector.
+    entry.idIndex.clear();
+    entry.idIndex.reserve(entry.messages.size());
+    entry.baseSeq = 0;
     
-    if (ts.type() == QVariant::DateTime) {
-        return ts.toDateTime();
+    int out = 0;
+    for (int i = 0; i < entry.messages.size(); ++i) {
+        const QString id = entry.messages.at(i).id;
+        if (id.isEmpty() || entry.idIndex.contains(id)) {
+            continue;
+        }
+        if (out != i) {
+            entry.messages[out] = entry.messages.at(i);
+        }
+        entry.idIndex.insert(id, out);
+        ++out;
     }
-    if (ts.type() == QVariant::String) {
-        return QDateTime::fromString(ts.toString(), Qt::ISODate);
+    entry.messages.resize(out);
+}
+
+void MessageCache::reindexFrom(CacheEntry& entry, int from) {
+    for (int i = from; i < entry.messages.size(); ++i) {
+        entry.idIndex[entry.messages.at(i).id] = entry.baseSeq + i;
     }
-    if (ts.type() == QVariant::LongLong || ts.type() == QVariant::Double) {
-        return QDateTime::fromMSecsSinceEpoch(ts.toLongLong());
+}
+
+int MessageCache::insertSorted(CacheEntry& entry, const CachedMessage& message) {
+    CachedMessageList& messages = entry.messages;
+    
+    // Fast path: live messages almost always arrive newest-last
+    if (messages.isEmpty() || messages.last().createdAt <= message.createdAt) {
+        messages.append(message);
+        entry.idIndex.insert(message.id, entry.baseSeq + messages.size() - 1);
+        return messages.size() - 1;
     }
     
-    return QDateTime();
+    CachedMessageList::iterator pos = std::upper_bound(messages.begin(), messages.end(),
+                                                       message, &MessageCache::olderThan);
+    int idx = static_cast<int>(pos - messages.begin());
+    messages.insert(idx, message);
+    
+    if (idx == 0) {
+        // Older than everything we hold - just move the base
+        entry.baseSeq -= 1;
+        entry.idIndex.insert(message.id, entry.baseSeq);
+    } else {
+        reindexFrom(entry, idx);
+    }
+    return idx;
 }
 
-void MessageCache::sortMessages(QVariantList& messages) {
-    // Sort by timestamp (oldest first for chat display)
-    std::sort(messages.begin(), messages.end(), 
-        [this](const QVariant& a, const QVariant& b) {
-            QDateTime tsA = extractTimestamp(a.toMap());
-            QDateTime tsB = extractTimestamp(b.toMap());
-            return tsA < tsB;
-        });
+bool MessageCache::ensureLoaded(const QString& channelId) {
+    if (m_messages.contains(channelId)) {
+        return true;
+    }
+    
+    MessageStore::Snapshot snapshot;
+    if (!m_store.load(channelId, snapshot)) {
+        return false;
+    }
+    
+    CacheEntry entry;
+    entry.messages = snapshot.messages;
+    entry.serverId = snapshot.serverId;
+    entry.hasMoreHistory = snapshot.hasMoreHistory;
+    // fetchedAt stays null: disk data always counts as stale, so the usual
+    // stale-while-revalidate refresh runs right after it is served
+    m_messages[channelId] = entry;
+    rebuildIndex(m_messages[channelId]);
+    touch(m_messages[channelId]);
+    scheduleEviction();
+    
+    qDebug() << "MessageCache: Restored" << entry.messages.size() 
+             << "messages from disk for channel" << channelId;
+    return true;
 }
 
-void MessageCache::trimMessages(CacheEntry& entry) {
-    // Keep only the most recent messages if over limit
-    if (entry.messages.size() > m_maxMessagesPerChannel) {
-        // Remove oldest messages (from the beginning)
-        int toRemove = entry.messages.size() - m_maxMessagesPerChannel;
-        entry.messages = entry.messages.mid(toRemove);
-        entry.hasMoreHistory = true;  // Since we trimmed, there are more to load
+void MessageCache::markDirty(const QString& channelId) {
+    // Called after every change to a channel: its size needs recounting
+    // and it may need writing to disk
+    QHash<QString, CacheEntry>::iterator it = m_messages.find(channelId);
+    if (it != m_messages.end()) {
+        it.value().sizeValid = false;
+    }
+    scheduleEviction();
+    
+    if (!m_store.isEnabled()) {
+        return;
+    }
+    m_dirtyChannels.insert(channelId);
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
     }
 }
 
-int MessageCache::findMessageIndex(const QVariantList& messages, const QString& messageId) const {
-    for (int i = 0; i < messages.size(); ++i) {
-        if (extractId(messages[i].toMap()) == messageId) {
-            return i;
+void MessageCache::flush() {
+    m_flushTimer->stop();
+    
+    for (const QString& channelId : m_dirtyChannels) {
+        QHash<QString, CacheEntry>::const_iterator it = m_messages.constFind(channelId);
+        if (it != m_messages.constEnd()) {
+            writeSnapshot(channelId, it.value());
         }
     }
-    return -1;
+    m_dirtyChannels.clear();
+}
+
+void MessageCache::writeSnapshot(const QString& channelId, const CacheEntry& entry) {
+    MessageStore::Snapshot snapshot;
+    snapshot.serverId = entry.serverId;
+    snapshot.hasMoreHistory = entry.hasMoreHistory;
+    snapshot.messages = entry.messages;
+    m_store.save(channelId, snapshot);
+}
+
+// ============================================================================
+// Memory budget
+// ============================================================================
+
+qint64 MessageCache::entryBytes(const CacheEntry& entry) {
+    qint64 bytes = sizeof(CacheEntry);
+    for (const CachedMessage& msg : entry.messages) {
+        bytes += msg.approximateSize();
+        // idIndex node: key shares the ID string, so just the node itself
+        bytes += sizeof(QString) + sizeof(qint64) + 16;
+    }
+    return bytes;
+}
+
+bool MessageCache::isPinned(const QString& channelId) const {
+    return channelId == m_activeChannelId ||
+           m_recentChannels.contains(channelId) ||
+           m_deltaSyncs.contains(channelId);
+}
+
+void MessageCache::noteChannelViewed(const QString& channelId) {
+    if (channelId.isEmpty()) {
+        return;
+    }
+    
+    m_recentChannels.removeAll(channelId);
+    m_recentChannels.prepend(channelId);
+    while (m_recentChannels.size() > kPinnedRecentChannels) {
+        m_recentChannels.removeLast();
+    }
+    
+    QHash<QString, CacheEntry>::iterator it = m_messages.find(channelId);
+    if (it != m_messages.end()) {
+        touch(it.value());
+    }
+}
+
+void MessageCache::scheduleEviction() {
+    if (!m_evictTimer->isActive()) {
+        m_evictTimer->start();
+    }
+}
+
+void MessageCache::evictIfNeeded() {
+    qint64 totalBytes = 0;
+    for (QHash<QString, CacheEntry>::iterator it = m_messages.begin(); it != m_messages.end(); ++it) {
+        CacheEntry& entry = it.value();
+        if (!entry.sizeValid) {
+            entry.approxBytes = entryBytes(entry);
+            entry.sizeValid = true;
+        }
+        totalBytes += entry.approxBytes;
+    }
+    
+    while (m_messages.size() > m_maxChannels || totalBytes > m_maxBytes) {
+        // Least recently used channel that isn't pinned
+        QHash<QString, CacheEntry>::iterator victim = m_messages.end();
+        for (QHash<QString, CacheEntry>::iterator it = m_messages.begin(); it != m_messages.end(); ++it) {
+            if (isPinned(it.key())) {
+                continue;
+            }
+            if (victim == m_messages.end() || it.value().lastAccess < victim.value().lastAccess) {
+                victim = it;
+            }
+        }
+        if (victim == m_messages.end()) {
+            break;  // Everything left is pinned
+        }
+        
+        const QString channelId = victim.key();
+        totalBytes -= victim.value().approxBytes;
+        
+        // Unsaved changes go to disk first so the channel comes back from
+        // the snapshot instead of the network
+        if (m_dirtyChannels.remove(channelId)) {
+            writeSnapshot(channelId, victim.value());
+        }
+        m_messages.erase(victim);
+        ++m_evictions;
+        
+        qDebug() << "MessageCache: Evicted channel" << channelId
+                 << "(channels:" << m_messages.size() << "bytes:" << totalBytes << ")";
+    }
+}
+
+QVariantMap MessageCache::stats() const {
+    qint64 totalBytes = 0;
+    int totalMessages = 0;
+    int pinned = 0;
+    for (QHash<QString, CacheEntry>::const_iterator it = m_messages.constBegin(); it != m_messages.constEnd(); ++it) {
+        const CacheEntry& entry = it.value();
+        totalBytes += entry.sizeValid ? entry.approxBytes : entryBytes(entry);
+        totalMessages += entry.messages.size();
+        if (isPinned(it.key())) {
+            pinned++;
+        }
+    }
+    
+    QVariantMap result;
+    result["channels"] = m_messages.size();
+    result["messages"] = totalMessages;
+    result["approxBytes"] = totalBytes;
+    result["maxBytes"] = m_maxBytes;
+    result["maxChannels"] = m_maxChannels;
+    result["pinnedChannels"] = pinned;
+    result["evictions"] = m_evictions;
+    return result;
+}
+
+QVariantList MessageCache::cachedMessages(const QString& channelId) {
+    if (channelId.isEmpty() || !ensureLoaded(channelId)) {
+        return QVariantList();
+    }
+    
+    CacheEntry& entry = m_messages[channelId];
+    touch(entry);
+    
+    const CachedMessageList& messages = entry.messages;
+    QVariantList result;
+    result.reserve(messages.size());
+    for (const CachedMessage& msg : messages) {
+        result.append(msg.toVariantMap());
+    }
+    return result;
+}
+
+QVariantList MessageCache::messagesAfter(const QString& channelId, const QString& messageId,
+                                        int limit, bool* reachedNewest) {
+    *reachedNewest = false;
+    if (channelId.isEmpty() || messageId.isEmpty() || !ensureLoaded(channelId)) {
+        return QVariantList();
+    }
+    
+    CacheEntry& entry = m_messages[channelId];
+    int idx = findMessageIndex(entry, messageId);
+    if (idx < 0) {
+        return QVariantList();
+    }
+    touch(entry);
+    
+    int first = idx + 1;
+    int end = qMin(entry.messages.size(), first + limit);
+    QVariantList result;
+    result.reserve(end - first);
+    for (int i = first; i < end; ++i) {
+        result.append(entry.messages.at(i).toVariantMap());
+    }
+    *reachedNewest = (end == entry.messages.size());
+    return result;
+}
+
+bool MessageCache::latestPage(const QString& channelId, int limit, QVariantList& out) {
+    if (channelId.isEmpty() || limit <= 0 || !ensureLoaded(channelId)) {
+        return false;
+    }
+    
+    CacheEntry& entry = m_messages[channelId];
+    touch(entry);
+    
+    int first = qMax(0, entry.messages.size() - limit);
+    out.clear();
+    out.reserve(entry.messages.size() - first);
+    for (int i = first; i < entry.messages.size(); ++i) {
+        out.append(entry.messages.at(i).toVariantMap());
+    }
+    return true;
 }
 
 // ============================================================================
@@ -103,7 +399,8 @@ QVariantList MessageCache::getMessages(const QString& serverId, const QString& c
         return QVariantList();
     }
     
-    bool hasData = m_messages.contains(channelId);
+    // Falls back to the disk snapshot on cold start
+    bool hasData = ensureLoaded(channelId);
     bool needsRefresh = !hasData;
     
     if (hasData) {
@@ -115,10 +412,11 @@ QVariantList MessageCache::getMessages(const QString& serverId, const QString& c
     
     // Trigger background refresh if needed
     if (needsRefresh && !m_pendingFetches.contains(channelId)) {
-        refreshMessages(serverId, channelId);
+        syncMessages(serverId, channelId);
     }
     
-    return hasData ? m_messages[channelId].messages : QVariantList();
+    // Convert to QVariantMaps only here, at the QML boundary
+    return hasData ? cachedMessages(channelId) : QVariantList();
 }
 
 QVariantMap MessageCache::getMessage(const QString& channelId, const QString& messageId) {
@@ -126,14 +424,15 @@ QVariantMap MessageCache::getMessage(const QString& channelId, const QString& me
         return QVariantMap();
     }
     
-    if (!m_messages.contains(channelId)) {
+    if (!ensureLoaded(channelId)) {
         return QVariantMap();
     }
     
-    const QVariantList& messages = m_messages[channelId].messages;
-    int idx = findMessageIndex(messages, messageId);
+    CacheEntry& entry = m_messages[channelId];
+    touch(entry);
+    int idx = findMessageIndex(entry, messageId);
     if (idx >= 0) {
-        return messages[idx].toMap();
+        return entry.messages.at(idx).toVariantMap();
     }
     
     return QVariantMap();
@@ -172,6 +471,7 @@ void MessageCache::refreshMessages(const QString& serverId, const QString& chann
     req.serverId = serverId;
     req.channelId = channelId;
     req.isPagination = false;
+    req.limit = limit;
     m_pendingRequests[requestId] = req;
     
     // Store serverId for this channel
@@ -208,6 +508,7 @@ void MessageCache::loadMoreMessages(const QString& serverId, const QString& chan
     req.serverId = serverId;
     req.channelId = channelId;
     req.isPagination = true;
+    req.limit = limit;
     req.beforeMessageId = beforeMessageId;
     m_pendingRequests[requestId] = req;
     
@@ -250,28 +551,62 @@ void MessageCache::loadMessages(const QString& serverId, const QString& channelI
         entry.serverId = serverId;
     }
     
+    // Parse incoming maps into typed records once
+    CachedMessageList incoming;
+    incoming.reserve(messages.size());
+    
     if (prepend) {
-        // Loading historical messages - add to beginning
-        QVariantList combined = messages;
-        combined.append(entry.messages);
-        entry.messages = combined;
+        // Loading historical messages - skip anything we already hold
+        QSet<QString> seen;
+        for (const QVariant& v : messages) {
+            CachedMessage msg = CachedMessage::fromVariantMap(v.toMap());
+            if (msg.id.isEmpty() || entry.idIndex.contains(msg.id) || seen.contains(msg.id)) {
+                continue;
+            }
+            seen.insert(msg.id);
+            incoming.append(msg);
+        }
+        sortMessages(incoming);
+        
+        bool olderThanCached = entry.messages.isEmpty() || incoming.isEmpty() ||
+                               incoming.last().createdAt <= entry.messages.first().createdAt;
+        
+        if (olderThanCached) {
+            // Page slots in at the front: only the base sequence moves,
+            // existing index entries stay valid
+            entry.baseSeq -= incoming.size();
+            for (int i = 0; i < incoming.size(); ++i) {
+                entry.idIndex.insert(incoming.at(i).id, entry.baseSeq + i);
+            }
+            incoming += entry.messages;
+            entry.messages.swap(incoming);
+        } else {
+            // Overlapping page - both sides are ordered, so merge linearly
+            entry.messages = mergeSorted(incoming, entry.messages);
+            rebuildIndex(entry);
+        }
         entry.hasMoreHistory = hasMore && !messages.isEmpty();
     } else {
         // Fresh load - replace all
-        entry.messages = messages;
+        for (const QVariant& v : messages) {
+            incoming.append(CachedMessage::fromVariantMap(v.toMap()));
+        }
+        entry.messages.swap(incoming);
+        sortMessages(entry.messages);
+        rebuildIndex(entry);
         entry.hasMoreHistory = hasMore;
     }
     
     entry.fetchedAt = QDateTime::currentDateTime();
+    touch(entry);
     
-    // Sort and trim
-    sortMessages(entry.messages);
     trimMessages(entry);
     
     // Clear pending flags
     m_pendingFetches.remove(channelId + "_refresh");
     
     emit loadingMessages(channelId, false);
+    markDirty(channelId);
     bumpVersion();
     
     if (prepend) {
@@ -285,7 +620,7 @@ void MessageCache::loadMessages(const QString& serverId, const QString& channelI
 }
 
 void MessageCache::addMessage(const QString& channelId, const QVariantMap& message) {
-    QString messageId = extractId(message);
+    QString messageId = CachedMessage::extractId(message);
     if (channelId.isEmpty() || messageId.isEmpty()) {
         return;
     }
@@ -300,29 +635,29 @@ void MessageCache::addMessage(const QString& channelId, const QVariantMap& messa
     CacheEntry& entry = m_messages[channelId];
     
     // Check if already exists (might be echo from our own send)
-    int existingIdx = findMessageIndex(entry.messages, messageId);
+    int existingIdx = findMessageIndex(entry, messageId);
     if (existingIdx >= 0) {
         // Update existing
-        entry.messages[existingIdx] = message;
+        entry.messages[existingIdx] = CachedMessage::fromVariantMap(message);
+        markDirty(channelId);
         bumpVersion();
         emit messageUpdated(channelId, messageId);
         return;
     }
     
-    // Add new message
-    entry.messages.append(message);
+    // Add new message at its sorted position (keeps the index in step)
+    insertSorted(entry, CachedMessage::fromVariantMap(message));
     entry.fetchedAt = QDateTime::currentDateTime();
     
-    // Keep sorted
-    sortMessages(entry.messages);
     trimMessages(entry);
     
+    markDirty(channelId);
     bumpVersion();
     emit messageAdded(channelId, messageId);
 }
 
 void MessageCache::updateMessage(const QString& channelId, const QVariantMap& message) {
-    QString messageId = extractId(message);
+    QString messageId = CachedMessage::extractId(message);
     if (channelId.isEmpty() || messageId.isEmpty()) {
         return;
     }
@@ -332,11 +667,12 @@ void MessageCache::updateMessage(const QString& channelId, const QVariantMap& me
     }
     
     CacheEntry& entry = m_messages[channelId];
-    int idx = findMessageIndex(entry.messages, messageId);
+    int idx = findMessageIndex(entry, messageId);
     
     if (idx >= 0) {
-        entry.messages[idx] = message;
+        entry.messages[idx] = CachedMessage::fromVariantMap(message);
         entry.fetchedAt = QDateTime::currentDateTime();
+        markDirty(channelId);
         bumpVersion();
         emit messageUpdated(channelId, messageId);
     }
@@ -352,10 +688,13 @@ void MessageCache::removeMessage(const QString& channelId, const QString& messag
     }
     
     CacheEntry& entry = m_messages[channelId];
-    int idx = findMessageIndex(entry.messages, messageId);
+    int idx = findMessageIndex(entry, messageId);
     
     if (idx >= 0) {
-        entry.messages.removeAt(idx);
+        entry.messages.remove(idx);
+        entry.idIndex.remove(messageId);
+        reindexFrom(entry, idx);
+        markDirty(channelId);
         bumpVersion();
         emit messageRemoved(channelId, messageId);
     }
@@ -372,12 +711,13 @@ void MessageCache::updateMessageReactions(const QString& channelId, const QStrin
     }
     
     CacheEntry& entry = m_messages[channelId];
-    int idx = findMessageIndex(entry.messages, messageId);
+    int idx = findMessageIndex(entry, messageId);
     
     if (idx >= 0) {
-        QVariantMap msg = entry.messages[idx].toMap();
-        msg["reactions"] = reactions;
-        entry.messages[idx] = msg;
+        CachedMessage& msg = entry.messages[idx];
+        msg.reactions = reactions;
+        msg.setFlag(CachedMessage::HasReactions);
+        markDirty(channelId);
         bumpVersion();
         emit messageUpdated(channelId, messageId);
     }
@@ -403,7 +743,7 @@ void MessageCache::refreshStaleEntries(const QStringList& channelIds) {
             // Use the stored serverId from the cache entry
             const CacheEntry& entry = m_messages[channelId];
             if (!entry.serverId.isEmpty()) {
-                refreshMessages(entry.serverId, channelId);
+                syncMessages(entry.serverId, channelId);
             }
         }
     }
@@ -411,17 +751,23 @@ void MessageCache::refreshStaleEntries(const QStringList& channelIds) {
 
 void MessageCache::refreshActiveChannel() {
     if (!m_activeChannelId.isEmpty() && !m_activeServerId.isEmpty()) {
-        refreshMessages(m_activeServerId, m_activeChannelId);
+        syncMessages(m_activeServerId, m_activeChannelId);
     }
 }
 
 void MessageCache::setActiveChannel(const QString& serverId, const QString& channelId) {
     m_activeServerId = serverId;
     m_activeChannelId = channelId;
+    noteChannelViewed(channelId);
+    
+    // Pull the disk snapshot into memory so it can be shown right away
+    if (!channelId.isEmpty()) {
+        ensureLoaded(channelId);
+    }
     
     // If the new active channel is stale, refresh it immediately
     if (!channelId.isEmpty() && !serverId.isEmpty() && !isFresh(channelId)) {
-        refreshMessages(serverId, channelId);
+        syncMessages(serverId, channelId);
     }
 }
 
@@ -429,12 +775,24 @@ void MessageCache::clear() {
     m_messages.clear();
     m_pendingFetches.clear();
     m_pendingRequests.clear();
+    m_deltaSyncs.clear();
     m_activeChannelId.clear();
+    m_recentChannels.clear();
+    
+    // Drop the disk snapshots too so no data outlives the session
+    m_dirtyChannels.clear();
+    m_flushTimer->stop();
+    m_store.clear();
+    
     bumpVersion();
 }
 
 void MessageCache::clearChannel(const QString& channelId) {
     m_messages.remove(channelId);
+    m_deltaSyncs.remove(channelId);
+    m_recentChannels.removeAll(channelId);
+    m_dirtyChannels.remove(channelId);
+    m_store.remove(channelId);
     
     // Remove any pending fetches for this channel
     QSet<QString> toRemove;
@@ -450,6 +808,238 @@ void MessageCache::clearChannel(const QString& channelId) {
     bumpVersion();
 }
 
+// ============================================================================
+// Delta sync
+// ============================================================================
+
+void MessageCache::syncMessages(const QString& serverId, const QString& channelId, int limit) {
+    if (channelId.isEmpty() || serverId.isEmpty() || !m_apiClient) {
+        qWarning() << "MessageCache::syncMessages - invalid channel/server ID or no API client";
+        return;
+    }
+    
+    // Shares the refresh marker so a sync and a full refresh never overlap
+    QString fetchKey = channelId + "_refresh";
+    if (m_pendingFetches.contains(fetchKey)) {
+        return;
+    }
+    
+    ensureLoaded(channelId);
+    
+    // Need an anchor below the overlap window; with little or nothing
+    // cached the regular last-page fetch costs about the same
+    QHash<QString, CacheEntry>::iterator it = m_messages.find(channelId);
+    if (it == m_messages.end() || it.value().messages.size() <= kDeltaOverlap ||
+        limit <= kDeltaOverlap) {
+        refreshMessages(serverId, channelId, limit);
+        return;
+    }
+    
+    CacheEntry& entry = it.value();
+    entry.serverId = serverId;
+    
+    int anchorIdx = entry.messages.size() - kDeltaOverlap - 1;
+    
+    DeltaSync sync;
+    sync.serverId = serverId;
+    sync.limit = limit;
+    sync.anchorId = entry.messages.at(anchorIdx).id;
+    sync.anchorCreatedAt = entry.messages.at(anchorIdx).createdAt;
+    for (int i = anchorIdx + 1; i < entry.messages.size(); ++i) {
+        sync.window.insert(entry.messages.at(i).id);
+    }
+    m_deltaSyncs[channelId] = sync;
+    
+    m_pendingFetches.insert(fetchKey);
+    emit loadingMessages(channelId, true);
+    
+    requestDeltaPage(channelId, QString());
+}
+
+bool MessageCache::isSyncRequest(int requestId) const {
+    QHash<int, PendingRequest>::const_iterator it = m_pendingRequests.constFind(requestId);
+    return it != m_pendingRequests.constEnd() && it.value().isDelta;
+}
+
+void MessageCache::requestDeltaPage(const QString& channelId, const QString& beforeMessageId) {
+    const DeltaSync& sync = m_deltaSyncs[channelId];
+    
+    int requestId = m_apiClient->getMessages(sync.serverId, channelId, sync.limit, beforeMessageId);
+    
+    PendingRequest req;
+    req.serverId = sync.serverId;
+    req.channelId = channelId;
+    req.isDelta = true;
+    req.limit = sync.limit;
+    m_pendingRequests[requestId] = req;
+    
+    qDebug() << "MessageCache: Delta sync for channel" << channelId << "down to" << sync.anchorId
+             << (beforeMessageId.isEmpty() ? QStringLiteral("from latest")
+                                           : QStringLiteral("before ") + beforeMessageId);
+}
+
+void MessageCache::applyDeltaPage(const QString& channelId, const QVariantList& messages) {
+    QHash<QString, DeltaSync>::iterator syncIt = m_deltaSyncs.find(channelId);
+    if (syncIt == m_deltaSyncs.end() || !m_messages.contains(channelId)) {
+        // Channel was cleared while the page was in flight
+        m_deltaSyncs.remove(channelId);
+        m_pendingFetches.remove(channelId + "_refresh");
+        return;
+    }
+    
+    DeltaSync& sync = syncIt.value();
+    
+    CachedMessageList incoming;
+    incoming.reserve(messages.size());
+    for (const QVariant& v : messages) {
+        CachedMessage msg = CachedMessage::fromVariantMap(v.toMap());
+        if (!msg.id.isEmpty()) {
+            incoming.append(msg);
+        }
+    }
+    sortMessages(incoming);
+    
+    // Pages walk backwards from the latest message; the catch-up is
+    // contiguous with the cache once a page reaches the anchor. A short
+    // page means the start of the channel was reached instead.
+    bool pageFull = messages.size() >= sync.limit;
+    bool reachedAnchor = !pageFull;
+    for (const CachedMessage& msg : incoming) {
+        if (msg.id == sync.anchorId || msg.createdAt <= sync.anchorCreatedAt) {
+            reachedAnchor = true;
+            break;
+        }
+    }
+    
+    sync.fetched = mergeSorted(incoming, sync.fetched);
+    
+    if (reachedAnchor) {
+        mergeDeltaSync(channelId);
+        return;
+    }
+    
+    if (incoming.isEmpty()) {
+        // Nothing to page from; keep the cache as it is and stay stale
+        finishDeltaSync(channelId, false);
+        return;
+    }
+    
+    if (sync.fetched.size() < m_maxMessagesPerChannel) {
+        requestDeltaPage(channelId, incoming.first().id);
+        return;
+    }
+    
+    // The gap is wider than the cache keeps: what was fetched can't be
+    // joined to the cached range, so it replaces it
+    replaceFromDeltaSync(channelId);
+}
+
+void MessageCache::mergeDeltaSync(const QString& channelId) {
+    DeltaSync& sync = m_deltaSyncs[channelId];
+    CacheEntry& entry = m_messages[channelId];
+    
+    // Unknown IDs above the anchor are new; known ones are compared for edits
+    QSet<QString> seen;
+    for (const CachedMessage& msg : sync.fetched) {
+        seen.insert(msg.id);
+        int idx = findMessageIndex(entry, msg.id);
+        if (idx < 0) {
+            if (msg.createdAt > sync.anchorCreatedAt) {
+                insertSorted(entry, msg);
+                sync.addedIds.append(msg.id);
+            }
+        } else if (!entry.messages.at(idx).sameContent(msg)) {
+            entry.messages[idx] = msg;
+            sync.updatedIds.append(msg.id);
+        }
+    }
+    
+    // Everything from the anchor up was fetched, so a window message that
+    // isn't there any more was deleted. An empty result is ambiguous (e.g.
+    // an error body), so nothing is inferred from it.
+    if (!sync.fetched.isEmpty()) {
+        for (const QString& id : sync.window) {
+            if (seen.contains(id)) {
+                continue;
+            }
+            int idx = findMessageIndex(entry, id);
+            if (idx < 0) {
+                continue;
+            }
+            entry.messages.remove(idx);
+            entry.idIndex.remove(id);
+            reindexFrom(entry, idx);
+            sync.removedIds.append(id);
+        }
+    }
+    
+    finishDeltaSync(channelId, true);
+}
+
+void MessageCache::replaceFromDeltaSync(const QString& channelId) {
+    DeltaSync sync = m_deltaSyncs.take(channelId);
+    m_pendingFetches.remove(channelId + "_refresh");
+    emit loadingMessages(channelId, false);
+    
+    CacheEntry& entry = m_messages[channelId];
+    entry.messages = sync.fetched;
+    rebuildIndex(entry);
+    entry.hasMoreHistory = true;
+    entry.fetchedAt = QDateTime::currentDateTime();
+    trimMessages(entry);
+    
+    markDirty(channelId);
+    bumpVersion();
+    emit messagesReset(channelId);
+    
+    qDebug() << "MessageCache: Delta gap too large for channel" << channelId
+             << "- replaced cache with the latest" << entry.messages.size() << "messages";
+}
+
+void MessageCache::finishDeltaSync(const QString& channelId, bool complete) {
+    DeltaSync sync = m_deltaSyncs.take(channelId);
+    m_pendingFetches.remove(channelId + "_refresh");
+    emit loadingMessages(channelId, false);
+    
+    if (!m_messages.contains(channelId)) {
+        return;
+    }
+    
+    CacheEntry& entry = m_messages[channelId];
+    if (complete) {
+        entry.fetchedAt = QDateTime::currentDateTime();
+    }
+    trimMessages(entry);
+    
+    if (sync.addedIds.isEmpty() && sync.updatedIds.isEmpty() && sync.removedIds.isEmpty()) {
+        qDebug() << "MessageCache: Channel" << channelId << "already up to date";
+        return;
+    }
+    
+    // Trimming may have dropped some of the added messages again
+    QVariantList added;
+    for (const QString& id : sync.addedIds) {
+        int idx = findMessageIndex(entry, id);
+        if (idx >= 0) {
+            added.append(entry.messages.at(idx).toVariantMap());
+        }
+    }
+    QVariantList updated;
+    for (const QString& id : sync.updatedIds) {
+        int idx = findMessageIndex(entry, id);
+        if (idx >= 0) {
+            updated.append(entry.messages.at(idx).toVariantMap());
+        }
+    }
+    
+    markDirty(channelId);
+    bumpVersion();
+    emit messagesSynced(channelId, added, updated, sync.removedIds);
+    
+    qDebug() << "MessageCache: Delta sync for channel" << channelId << "added" << added.size()
+             << "updated" << updated.size() << "removed" << sync.removedIds.size();
+}
+
 // ============================================================================
 // Slots for API responses
 // ============================================================================
@@ -462,6 +1052,11 @@ void MessageCache::onMessagesFetched(int requestId, const QString& serverId, con
     
     PendingRequest req = m_pendingRequests.take(requestId);
     
+    if (req.isDelta) {
+        applyDeltaPage(channelId, messages);
+        return;
+    }
+    
     // Remove pending fetch marker
     if (req.isPagination) {
         m_pendingFetches.remove(channelId + "_before_" + req.beforeMessageId);
@@ -470,7 +1065,7 @@ void MessageCache::onMessagesFetched(int requestId, const QString& serverId, con
     }
     
     // Determine if there are more messages based on response size
-    bool hasMore = messages.size() >= 50;  // Assuming 50 is the default limit
+    bool hasMore = messages.size() >= req.limit;
     
     loadMessages(serverId.isEmpty() ? req.serverId : serverId, channelId, messages, req.isPagination, hasMore);
 }
@@ -485,6 +1080,14 @@ void MessageCache::onMessagesFetchFailed(int requestId, const QString& serverId,
     
     PendingRequest req = m_pendingRequests.take(requestId);
     
+    if (req.isDelta) {
+        // Nothing is merged before the anchor is reached; the entry stays
+        // stale and the next refresh tries again
+        qWarning() << "MessageCache: Delta sync failed for channel" << channelId << ":" << error;
+        finishDeltaSync(channelId, false);
+        return;
+    }
+    
     if (req.isPagination) {
         m_pendingFetches.remove(channelId + "_before_" + req.beforeMessageId);
     } else {
@@ -8,6 +8,11 @@
 #include <QVariantList>
 #include <QDateTime>
 #include <QString>
+#include <QTimer>
+
+#include "cachedmessage.h"
+#include "messagestore.h"
+#include "versionbatcher.h"
 
 class ApiClient;
 
@@ -20,6 +25,12 @@ class ApiClient;
  * - Socket.IO event-driven updates
  * - Pagination support for message history
  * - Graceful handling of app suspension/reconnection
+ * - Optional on-disk snapshots for instant cold start (see MessageStore)
+ * - Global memory budget with LRU eviction of whole channels
+ * 
+ * Messages are stored per-channel as typed CachedMessage records in a
+ * contiguous vector; conversion to QVariantMap only happens at the QML
+ * boundary (getMessages()/getMessage()).
  * 
  * Messages are stored per-channel with support for:
  * - Adding new messages from socket events
@@ -38,7 +49,7 @@ class MessageCache : public QObject {
 
 public:
     explicit MessageCache(QObject *parent = nullptr);
-    ~MessageCache() override = default;
+    ~MessageCache() override;
     
     /**
      * @brief Set the API client for fetching messages.
@@ -56,6 +67,23 @@ public:
      */
     void setMaxMessagesPerChannel(int count);
     
+    /**
+     * @brief Enable the persistent on-disk tier in the given directory.
+     * Channels that are not in memory are served from their disk snapshot
+     * (marked stale, so a background refresh follows). Empty disables it.
+     */
+    void setStorageDirectory(const QString& path);
+    
+    /**
+     * @brief Set the global memory budget (default: 12 MB, 60 channels).
+     * When either limit is exceeded, the least recently used channels are
+     * evicted as a whole (written to disk first if the store is enabled).
+     * The active channel and the last few viewed channels are never evicted.
+     * @param maxBytes Approximate byte budget across all channels
+     * @param maxChannels Maximum number of channels held in memory
+     */
+    void setMemoryBudget(qint64 maxBytes, int maxChannels);
+    
     // ========================================================================
     // QML-accessible methods
     // ========================================================================
@@ -118,15 +146,54 @@ public:
      */
     Q_INVOKABLE int messageCount(const QString& channelId) const;
     
+    /**
+     * @brief Current memory usage, for tuning the budget.
+     * @return Map with channels, messages, approxBytes, maxBytes,
+     *         maxChannels, pinnedChannels and evictions
+     */
+    Q_INVOKABLE QVariantMap stats() const;
+    
     /**
      * @brief Get version counter for QML binding invalidation.
      */
-    int version() const { return m_version; }
+    int version() const { return m_versions.version(); }
+    
+    /// Coalesce versionChanged() until endBatch() (see VersionBatcher)
+    void beginBatch() { m_versions.begin(); }
+    void endBatch() { if (m_versions.end()) emit versionChanged(); }
     
     // ========================================================================
     // C++ methods for cache management
     // ========================================================================
     
+    /**
+     * @brief Get cached messages (oldest first) without triggering a refresh.
+     * Falls back to the on-disk snapshot if the channel isn't in memory.
+     */
+    QVariantList cachedMessages(const QString& channelId);
+    
+    /**
+     * @brief Get up to `limit` cached messages newer than a message (oldest first).
+     * Used to page rows back into a windowed MessageModel without a request.
+     * @param reachedNewest Set to true if the result ends at the newest cached message
+     * @return Empty list with reachedNewest false if the anchor isn't cached
+     */
+    QVariantList messagesAfter(const QString& channelId, const QString& messageId,
+                               int limit, bool* reachedNewest);
+    
+    /**
+     * @brief The newest `limit` cached messages, oldest first - the shape of
+     * a latest-page response. Answers a 304 for that page (see
+     * ApiClient::NotModifiedSource).
+     * @return false if the channel isn't cached
+     */
+    bool latestPage(const QString& channelId, int limit, QVariantList& out);
+    
+    /**
+     * @brief Write all modified channels to disk now (e.g. before suspension).
+     */
+    void flush();
+    
     /**
      * @brief Load messages from API response into cache.
      * @param serverId The server ID (for refresh lookup)
@@ -164,8 +231,29 @@ public:
      */
     void markAllStale();
     
+    /**
+     * @brief Incrementally bring a cached channel up to date.
+     * 
+     * Pages backwards from the latest message until it reaches the cached
+     * message just below a small overlap window at the tail of the cache,
+     * then merges what it found. Messages in the overlap window that changed
+     * or are missing are treated as edits/deletes. The latest page is a
+     * conditional request, so an unchanged channel costs one 304.
+     * Falls back to refreshMessages() when nothing usable is cached. If the
+     * gap is larger than the cache would keep anyway, the fetched messages
+     * replace the entry (messagesReset) instead of leaving a hole.
+     */
+    void syncMessages(const QString& serverId, const QString& channelId, int limit = 50);
+    
+    /**
+     * @brief Whether a request ID belongs to an in-flight delta sync.
+     * Delta pages are partial and must not be treated as a fresh page.
+     */
+    bool isSyncRequest(int requestId) const;
+    
     /**
      * @brief Refresh messages for specific channels (call after reconnection).
+     * Uses delta sync for channels that already have cached messages.
      * @param channelIds List of channel IDs to refresh
      */
     void refreshStaleEntries(const QStringList& channelIds);
@@ -182,6 +270,12 @@ public:
      */
     void setActiveChannel(const QString& serverId, const QString& channelId);
     
+    /**
+     * @brief Record that a channel was opened, pinning it against eviction
+     * for the next few channel switches. Does not trigger a refresh.
+     */
+    void noteChannelViewed(const QString& channelId);
+    
     /**
      * @brief Get the currently active channel.
      */
@@ -210,6 +304,21 @@ signals:
     void messageRemoved(const QString& channelId, const QString& messageId);
     void moreMessagesLoaded(const QString& channelId);
     void loadingMessages(const QString& channelId, bool isLoading);
+    
+    /**
+     * @brief Emitted once a delta sync has been merged.
+     * @param added New messages, oldest first
+     * @param updated Messages whose content changed in the overlap window
+     * @param removedIds Messages that disappeared from the overlap window
+     */
+    void messagesSynced(const QString& channelId, const QVariantList& added,
+                        const QVariantList& updated, const QStringList& removedIds);
+    
+    /**
+     * @brief Emitted when a delta sync couldn't reach the cached range and
+     * replaced the channel's messages with the latest ones instead.
+     */
+    void messagesReset(const QString& channelId);
 
 public slots:
     void onMessagesFetched(int requestId, const QString& serverId, const QString& channelId,
@@ -219,11 +328,23 @@ public slots:
 
 private:
     struct CacheEntry {
-        QVariantList messages;
+        CachedMessageList messages;  // Sorted oldest first
+        
+        // messageId -> sequence number; position = seq - baseSeq.
+        // Prepends and front trims only move baseSeq, so they don't
+        // shift every stored index.
+        QHash<QString, qint64> idIndex;
+        qint64 baseSeq = 0;
+        
         QDateTime fetchedAt;
         QString serverId;  // Track which server this channel belongs to
         bool hasMoreHistory = true;  // Whether there are older messages to load
         
+        // LRU bookkeeping for the global memory budget
+        quint64 lastAccess = 0;
+        qint64 approxBytes = 0;
+        bool sizeValid = false;  // approxBytes needs recomputing
+        
         bool isStale(int ttlSeconds) const {
             return fetchedAt.isNull() || 
                    fetchedAt.secsTo(QDateTime::currentDateTime()) > ttlSeconds;
@@ -233,31 +354,77 @@ private:
     struct PendingRequest {
         QString serverId;
         QString channelId;
-        bool isPagination;  // true if loading older messages
+        bool isPagination = false;  // true if loading older messages
+        bool isDelta = false;       // true if part of a delta sync
+        int limit = 50;             // Requested page size
         QString beforeMessageId;
     };
     
+    // State of an in-flight delta sync for one channel
+    struct DeltaSync {
+        QString serverId;
+        int limit = 50;
+        QString anchorId;          // Newest cached message below the window
+        qint64 anchorCreatedAt = 0;
+        QSet<QString> window;      // Cached IDs above the anchor
+        CachedMessageList fetched; // Pages received so far, oldest first
+        QStringList addedIds;
+        QStringList updatedIds;
+        QStringList removedIds;
+    };
+    
     // Message storage: channelId -> cache entry
     QHash<QString, CacheEntry> m_messages;
     
     // Track pending fetches to avoid duplicates
     QSet<QString> m_pendingFetches;
     QHash<int, PendingRequest> m_pendingRequests;
+    QHash<QString, DeltaSync> m_deltaSyncs;
     
     // Configuration
     ApiClient* m_apiClient = nullptr;
     int m_ttlSeconds = 120;  // 2 minutes default
     int m_maxMessagesPerChannel = 200;
-    int m_version = 0;
+    VersionBatcher m_versions;
     QString m_activeChannelId;
     QString m_activeServerId;
     
-    void bumpVersion();
-    QString extractId(const QVariantMap& item) const;
-    QDateTime extractTimestamp(const QVariantMap& message) const;
+    // Global memory budget
+    qint64 m_maxBytes = 12 * 1024 * 1024;
+    int m_maxChannels = 60;
+    quint64 m_accessClock = 0;
+    int m_evictions = 0;
+    QStringList m_recentChannels;  // Most recently viewed first
+    QTimer* m_evictTimer;
+    
+    // Persistent tier: modified channels are written after a short delay
+    MessageStore m_store;
+    QSet<QString> m_dirtyChannels;
+    QTimer* m_flushTimer;
+    
+    void bumpVersion() { if (m_versions.bump()) emit versionChanged(); }
+    bool ensureLoaded(const QString& channelId);
+    void markDirty(const QString& channelId);
+    void writeSnapshot(const QString& channelId, const CacheEntry& entry);
+    void touch(CacheEntry& entry) { entry.lastAccess = ++m_accessClock; }
+    bool isPinned(const QString& channelId) const;
+    void scheduleEviction();
+    void evictIfNeeded();
+    static qint64 entryBytes(const CacheEntry& entry);
     void trimMessages(CacheEntry& entry);
-    void sortMessages(QVariantList& messages);
-    int findMessageIndex(const QVariantList& messages, const QString& messageId) const;
+    void sortMessages(CachedMessageList& messages);
+    static CachedMessageList mergeSorted(const CachedMessageList& a, const CachedMessageList& b);
+    static bool olderThan(const CachedMessage& a, const CachedMessage& b) { return a.createdAt < b.createdAt; }
+    static bool newerThan(const CachedMessage& a, const CachedMessage& b) { return a.createdAt > b.createdAt; }
+    int findMessageIndex(const CacheEntry& entry, const QString& messageId) const;
+    void rebuildIndex(CacheEntry& entry);
+    void reindexFrom(CacheEntry& entry, int from);
+    int insertSorted(CacheEntry& entry, const CachedMessage& message);
+    void requestDeltaPage(const QString& channelId, const QString& beforeMessageId);
+    void applyDeltaPage(const QString& channelId, const QVariantList& messages);
+    void mergeDeltaSync(const QString& channelId);
+    void replaceFromDeltaSync(const QString& channelId);
+    void finishDeltaSync(const QString& channelId, bool complete);
 };
 
 #endif // MESSAGECACHE_H
\ No newline at end of file
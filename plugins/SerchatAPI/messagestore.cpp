@@ -0,0 +1,125 @@
+#include "messagestore.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QCryptographicHash>
+#include <QRegularExpression>
+#include <QDebug>
+
+namespace {
+const quint32 kMagic = 0x53434d53;  // "SCMS"
+const quint16 kVersion = 1;
+const QDataStream::Version kStreamVersion = QDataStream::Qt_5_9;
+}
+
+void MessageStore::setDirectory(const QString& path) {
+    m_directory = path;
+    if (!m_directory.isEmpty()) {
+        QDir().mkpath(m_directory);
+    }
+}
+
+QString MessageStore::filePath(const QString& channelId) const {
+    // Channel IDs are normally plain hex object IDs; hash anything else so
+    // it can't escape the directory or produce an invalid file name
+    static const QRegularExpression safeName("^[A-Za-z0-9_-]{1,64}$");
+    QString name = channelId;
+    if (!safeName.match(name).hasMatch()) {
+        name = QString::fromLatin1(
+            QCryptographicHash::hash(channelId.toUtf8(), QCryptographicHash::Sha1).toHex());
+    }
+    return m_directory + "/" + name + ".msgs";
+}
+
+bool MessageStore::load(const QString& channelId, Snapshot& out) const {
+    if (!isEnabled() || channelId.isEmpty()) {
+        return false;
+    }
+
+    QFile file(filePath(channelId));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(kStreamVersion);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != kMagic || version != kVersion) {
+        qWarning() << "MessageStore: Ignoring incompatible snapshot for channel" << channelId;
+        return false;
+    }
+
+    Snapshot snapshot;
+    qint32 count = 0;
+    in >> snapshot.serverId >> snapshot.hasMoreHistory >> count;
+    if (in.status() != QDataStream::Ok || count < 0) {
+        return false;
+    }
+
+    snapshot.messages.reserve(count);
+    for (qint32 i = 0; i < count; ++i) {
+        CachedMessage msg;
+        in >> msg.id >> msg.senderId >> msg.channelId >> msg.createdAt
+           >> msg.text >> msg.flags >> msg.reactions >> msg.extra;
+        if (in.status() != QDataStream::Ok) {
+            qWarning() << "MessageStore: Truncated snapshot for channel" << channelId;
+            return false;
+        }
+        snapshot.messages.append(msg);
+    }
+
+    out = snapshot;
+    return true;
+}
+
+bool MessageStore::save(const QString& channelId, const Snapshot& snapshot) const {
+    if (!isEnabled() || channelId.isEmpty()) {
+        return false;
+    }
+
+    QSaveFile file(filePath(channelId));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "MessageStore: Cannot write snapshot for channel" << channelId
+                   << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(kStreamVersion);
+
+    out << kMagic << kVersion << snapshot.serverId << snapshot.hasMoreHistory
+        << static_cast<qint32>(snapshot.messages.size());
+    for (const CachedMessage& msg : snapshot.messages) {
+        out << msg.id << msg.senderId << msg.channelId << msg.createdAt
+            << msg.text << msg.flags << msg.reactions << msg.extra;
+    }
+
+    if (out.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+void MessageStore::remove(const QString& channelId) const {
+    if (!isEnabled() || channelId.isEmpty()) {
+        return;
+    }
+    QFile::remove(filePath(channelId));
+}
+
+void MessageStore::clear() const {
+    if (!isEnabled()) {
+        return;
+    }
+
+    QDir dir(m_directory);
+    const QStringList files = dir.entryList(QStringList() << "*.msgs", QDir::Files);
+    for (const QString& name : files) {
+        dir.remove(name);
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef MESSAGESTORE_H
+#define MESSAGESTORE_H
+
+#include <QString>
+
+#include "cachedmessage.h"
+
+/**
+ * @brief Persistent per-channel message snapshots on disk.
+ *
+ * Backs MessageCache so a channel can be painted right after a cold start,
+ * before any network round trip. Each channel is one compact binary file
+ * (QDataStream) under the configured directory, written atomically via
+ * QSaveFile so a killed process never leaves a torn snapshot behind.
+ *
+ * File layout (version 1):
+ *   quint32 magic, quint16 version, QString serverId, bool hasMoreHistory,
+ *   qint32 count, then per message:
+ *   id, senderId, channelId, createdAt, text, flags, reactions, extra
+ */
+class MessageStore {
+public:
+    struct Snapshot {
+        QString serverId;
+        bool hasMoreHistory = true;
+        CachedMessageList messages;  // Oldest first
+    };
+
+    MessageStore() = default;
+
+    /**
+     * @brief Set the directory snapshots live in. Empty disables the store.
+     */
+    void setDirectory(const QString& path);
+    QString directory() const { return m_directory; }
+    bool isEnabled() const { return !m_directory.isEmpty(); }
+
+    /**
+     * @brief Read a channel snapshot. Returns false if missing or unreadable.
+     */
+    bool load(const QString& channelId, Snapshot& out) const;
+
+    /**
+     * @brief Write a channel snapshot, replacing any previous one.
+     */
+    bool save(const QString& channelId, const Snapshot& snapshot) const;
+
+    /**
+     * @brief Delete a single channel snapshot.
+     */
+    void remove(const QString& channelId) const;
+
+    /**
+     * @brief Delete all snapshots (e.g. on logout).
+     */
+    void clear() const;
+
+private:
+    QString m_directory;
+
+    QString filePath(const QString& channelId) const;
+};
+
+#endif // MESSAGESTORE_H
@@ -73,7 +73,8 @@ void GenericListModel::setItems(const QVariantList& items)
     beginResetModel();
     
     m_items.clear();
-    m_idToIndex.clear();
+    m_index.clear();
+    m_index.reserve(items.count());
     
     // Auto-detect roles from first item if not already set
     if (!items.isEmpty() && m_roleNames.isEmpty()) {
@@ -82,10 +83,7 @@ void GenericListModel::setItems(const QVariantList& items)
     
     for (int i = 0; i < items.count(); ++i) {
         QVariantMap item = items[i].toMap();
-        QString id = extractId(item);
-        if (!id.isEmpty()) {
-            m_idToIndex[id] = i;
-        }
+        m_index.setRow(extractId(item), i);
         m_items.append(item);
     }
     
@@ -100,7 +98,7 @@ void GenericListModel::clear()
     
     beginResetModel();
     m_items.clear();
-    m_idToIndex.clear();
+    m_index.clear();
     endResetModel();
     
     emit countChanged();
@@ -111,7 +109,7 @@ void GenericListModel::append(const QVariantMap& item)
     ensureRolesFromItem(item);
     
     QString id = extractId(item);
-    if (!id.isEmpty() && m_idToIndex.contains(id)) {
+    if (!id.isEmpty() && m_index.contains(id)) {
         // Item already exists, update instead
         updateItem(id, item);
         return;
@@ -121,9 +119,7 @@ void GenericListModel::append(const QVariantMap& item)
     
     beginInsertRows(QModelIndex(), index, index);
     m_items.append(item);
-    if (!id.isEmpty()) {
-        m_idToIndex[id] = index;
-    }
+    m_index.setRow(id, index);
     endInsertRows();
     
     emit countChanged();
@@ -142,7 +138,7 @@ void GenericListModel::appendItems(const QVariantList& items)
         ensureRolesFromItem(item);
         
         QString id = extractId(item);
-        if (id.isEmpty() || !m_idToIndex.contains(id)) {
+        if (id.isEmpty() || !m_index.contains(id)) {
             toAdd.append(item);
         }
     }
@@ -154,18 +150,13 @@ void GenericListModel::appendItems(const QVariantList& items)
     int last = first + toAdd.count() - 1;
     
     beginInsertRows(QModelIndex(), first, last);
-    for (const QVariantMap& item : toAdd) {
-        QString id = extractId(item);
-        if (!id.isEmpty()) {
-            m_idToIndex[id] = m_items.count();
-        }
-        m_items.append(item);
-    }
+    m_items.append(toAdd);
+    indexRowsInserted(first, toAdd.count());
     endInsertRows();
     
     emit countChanged();
-    for (const QVariantMap& item : toAdd) {
-        emit itemAdded(extractId(item), m_items.count() - toAdd.count() + toAdd.indexOf(item));
+    for (int i = 0; i < toAdd.count(); ++i) {
+        emit itemAdded(extractId(toAdd.at(i)), first + i);
     }
 }
 
@@ -174,14 +165,14 @@ void GenericListModel::prepend(const QVariantMap& item)
     ensureRolesFromItem(item);
     
     QString id = extractId(item);
-    if (!id.isEmpty() && m_idToIndex.contains(id)) {
+    if (!id.isEmpty() && m_index.contains(id)) {
         updateItem(id, item);
         return;
     }
     
     beginInsertRows(QModelIndex(), 0, 0);
     m_items.prepend(item);
-    rebuildIndexMap();
+    indexRowsInserted(0, 1);
     endInsertRows();
     
     emit countChanged();
@@ -196,14 +187,14 @@ void GenericListModel::insert(int index, const QVariantMap& item)
     ensureRolesFromItem(item);
     
     QString id = extractId(item);
-    if (!id.isEmpty() && m_idToIndex.contains(id)) {
+    if (!id.isEmpty() && m_index.contains(id)) {
         updateItem(id, item);
         return;
     }
     
     beginInsertRows(QModelIndex(), index, index);
     m_items.insert(index, item);
-    rebuildIndexMap();
+    indexRowsInserted(index, 1);
     endInsertRows();
     
     emit countChanged();
@@ -212,10 +203,10 @@ void GenericListModel::insert(int index, const QVariantMap& item)
 
 bool GenericListModel::updateItem(const QString& id, const QVariantMap& item)
 {
-    if (!m_idToIndex.contains(id))
+    int index = m_index.rowOf(id);
+    if (index < 0)
         return false;
-    
-    int index = m_idToIndex[id];
+
     m_items[index] = item;
     
     QModelIndex modelIndex = createIndex(index, 0);
@@ -227,10 +218,10 @@ bool GenericListModel::updateItem(const QString& id, const QVariantMap& item)
 
 bool GenericListModel::updateItemProperty(const QString& id, const QString& property, const QVariant& value)
 {
-    if (!m_idToIndex.contains(id))
+    int index = m_index.rowOf(id);
+    if (index < 0)
         return false;
-    
-    int index = m_idToIndex[id];
+
     m_items[index][property] = value;
     
     // Find the role for this property
@@ -251,14 +242,14 @@ bool GenericListModel::updateItemProperty(const QString& id, const QString& prop
 
 bool GenericListModel::removeItem(const QString& id)
 {
-    if (!m_idToIndex.contains(id))
+    int index = m_index.rowOf(id);
+    if (index < 0)
         return false;
     
-    int index = m_idToIndex[id];
-    
     beginRemoveRows(QModelIndex(), index, index);
+    m_index.remove(id);
     m_items.removeAt(index);
-    rebuildIndexMap();
+    indexRowsRemoved(index, 1);
     endRemoveRows();
     
     emit countChanged();
@@ -275,8 +266,9 @@ void GenericListModel::removeAt(int index)
     QString id = extractId(m_items[index]);
     
     beginRemoveRows(QModelIndex(), index, index);
+    m_index.remove(id);
     m_items.removeAt(index);
-    rebuildIndexMap();
+    indexRowsRemoved(index, 1);
     endRemoveRows();
     
     emit countChanged();
@@ -285,14 +277,15 @@ void GenericListModel::removeAt(int index)
 
 bool GenericListModel::contains(const QString& id) const
 {
-    return m_idToIndex.contains(id);
+    return m_index.contains(id);
 }
 
 QVariantMap GenericListModel::get(const QString& id) const
 {
-    if (!m_idToIndex.contains(id))
+    int index = m_index.rowOf(id);
+    if (index < 0)
         return QVariantMap();
-    return m_items.at(m_idToIndex[id]);
+    return m_items.at(index);
 }
 
 QVariantMap GenericListModel::getAt(int index) const
@@ -304,7 +297,7 @@ QVariantMap GenericListModel::getAt(int index) const
 
 int GenericListModel::indexOf(const QString& id) const
 {
-    return m_idToIndex.value(id, -1);
+    return m_index.rowOf(id);
 }
 
 void GenericListModel::move(int from, int to)
@@ -319,7 +312,8 @@ void GenericListModel::move(int from, int to)
         return;
     
     m_items.move(from, to);
-    rebuildIndexMap();
+    m_index.renumber(qMin(from, to), qMax(from, to),
+                     [this](int i) { return extractId(m_items.at(i)); });
     
     endMoveRows();
 }
@@ -379,13 +373,19 @@ QString GenericListModel::extractId(const QVariantMap& item) const
 
 void GenericListModel::rebuildIndexMap()
 {
-    m_idToIndex.clear();
-    for (int i = 0; i < m_items.count(); ++i) {
-        QString id = extractId(m_items[i]);
-        if (!id.isEmpty()) {
-            m_idToIndex[id] = i;
-        }
-    }
+    m_index.rebuild(m_items.count(), [this](int i) { return extractId(m_items.at(i)); });
+}
+
+void GenericListModel::indexRowsInserted(int row, int count)
+{
+    m_index.rowsInserted(row, count, m_items.count(),
+                         [this](int i) { return extractId(m_items.at(i)); });
+}
+
+void GenericListModel::indexRowsRemoved(int row, int count)
+{
+    m_index.rowsRemoved(row, count, m_items.count(),
+                        [this](int i) { return extractId(m_items.at(i)); });
 }
 
 void GenericListModel::ensureRolesFromItem(const QVariantMap& item)
@@ -6,13 +6,15 @@
 #include <QVariantList>
 #include <QHash>
 
+#include "rowindex.h"
+
 /**
  * @brief A generic C++ list model for QML.
  * 
  * This model can be used for servers, channels, members, friends, etc.
  * It provides:
  * - Proper QAbstractListModel signals (preserves scroll position)
- * - O(1) item lookup by ID
+ * - O(1) item lookup by ID (prepend/append don't renumber existing rows)
  * - Dynamic role names (configurable per instance)
  * - Efficient batch operations
  * 
@@ -162,7 +164,7 @@ signals:
 private:
     QString m_idField;
     QList<QVariantMap> m_items;
-    QHash<QString, int> m_idToIndex;
+    RowIndex m_index;
     
     // Role management
     QHash<int, QByteArray> m_roleNames;
@@ -171,6 +173,8 @@ private:
     
     QString extractId(const QVariantMap& item) const;
     void rebuildIndexMap();
+    void indexRowsInserted(int row, int count);
+    void indexRowsRemoved(int row, int count);
     void ensureRolesFromItem(const QVariantMap& item);
 };
 
@@ -2,13 +2,20 @@
 #include "../userprofilecache.h"
 #include <QDebug>
 #include <QTimer>
+#include <algorithm>
 
 MessageModel::MessageModel(QObject *parent)
     : QAbstractListModel(parent)
+    , m_profileUpdateTimer(new QTimer(this))
     , m_userProfileCache(nullptr)
     , m_isDMMode(false)
     , m_hasMoreMessages(true)
+    , m_hasNewerMessages(false)
+    , m_windowSize(300)
 {
+    m_profileUpdateTimer->setSingleShot(true);
+    m_profileUpdateTimer->setInterval(0);
+    connect(m_profileUpdateTimer, &QTimer::timeout, this, &MessageModel::flushProfileUpdates);
 }
 
 MessageModel::~MessageModel()
@@ -40,11 +47,11 @@ QVariant MessageModel::data(const QModelIndex &index, int role) const
     case TextRole:
         return data.value("text").toString();
     case SenderIdRole:
-        return data.value("senderId").toString();
+        return msg.senderId;
     case SenderNameRole:
-        return getSenderName(data.value("senderId").toString());
+        return getSenderName(msg.senderId);
     case SenderAvatarRole:
-        return getSenderAvatar(data.value("senderId").toString());
+        return getSenderAvatar(msg.senderId);
     case TimestampRole:
         return data.value("createdAt");
     case IsEditedRole:
@@ -59,6 +66,12 @@ QVariant MessageModel::data(const QModelIndex &index, int role) const
         return data.value("attachments", QVariantList());
     case IsTempMessageRole:
         return msg.id.startsWith("temp_");
+    case ShowAvatarRole:
+        return (msg.groupFlags & ShowAvatarFlag) != 0;
+    case IsDayStartRole:
+        return (msg.groupFlags & DayStartFlag) != 0;
+    case IsFirstUnreadRole:
+        return !m_firstUnreadMessageId.isEmpty() && msg.id == m_firstUnreadMessageId;
     default:
         return QVariant();
     }
@@ -79,6 +92,9 @@ QHash<int, QByteArray> MessageModel::roleNames() const
     roles[ReactionsRole] = "reactions";
     roles[AttachmentsRole] = "attachments";
     roles[IsTempMessageRole] = "isTempMessage";
+    roles[ShowAvatarRole] = "showAvatar";
+    roles[IsDayStartRole] = "isDayStart";
+    roles[IsFirstUnreadRole] = "isFirstUnread";
     return roles;
 }
 
@@ -94,6 +110,19 @@ void MessageModel::setHasMoreMessages(bool hasMore)
     }
 }
 
+void MessageModel::setHasNewerMessages(bool hasNewer)
+{
+    if (m_hasNewerMessages != hasNewer) {
+        m_hasNewerMessages = hasNewer;
+        emit hasNewerMessagesChanged();
+    }
+}
+
+void MessageModel::setWindowSize(int rows)
+{
+    m_windowSize = rows;
+}
+
 // ============================================================================
 // Channel/DM Context
 // ============================================================================
@@ -110,6 +139,8 @@ void MessageModel::setChannel(const QString& serverId, const QString& channelId)
     m_dmRecipientId.clear();
     m_isDMMode = false;
     m_hasMoreMessages = true;
+    m_firstUnreadMessageId.clear();
+    setHasNewerMessages(false);
     
     emit serverIdChanged();
     emit channelIdChanged();
@@ -129,6 +160,8 @@ void MessageModel::setDMRecipient(const QString& recipientId)
     m_dmRecipientId = recipientId;
     m_isDMMode = true;
     m_hasMoreMessages = true;
+    m_firstUnreadMessageId.clear();
+    setHasNewerMessages(false);
     
     emit serverIdChanged();
     emit channelIdChanged();
@@ -138,12 +171,15 @@ void MessageModel::setDMRecipient(const QString& recipientId)
 
 void MessageModel::clear()
 {
+    setHasNewerMessages(false);
+    
     if (m_messages.isEmpty())
         return;
     
     beginResetModel();
     m_messages.clear();
-    m_idToIndex.clear();
+    m_index.clear();
+    m_senderIndex.clear();
     endResetModel();
     
     emit countChanged();
@@ -162,21 +198,28 @@ void MessageModel::prependMessage(const QVariantMap& message)
     }
     
     // Check for duplicates
-    if (m_idToIndex.contains(id)) {
+    if (m_index.contains(id)) {
         qDebug() << "[MessageModel] Skipping duplicate message:" << id;
         return;
     }
     
+    // The window doesn't reach the live end - inserting here would leave a
+    // gap. It gets paged in with the rest. Own pending sends still show.
+    if (m_hasNewerMessages && !id.startsWith(QStringLiteral("temp_"))) {
+        qDebug() << "[MessageModel] Window detached from live end, deferring:" << id;
+        return;
+    }
+    
     // Use proper model signals - this is the key to preserving scroll!
     beginInsertRows(QModelIndex(), 0, 0);
     
-    Message msg;
-    msg.id = id;
-    msg.data = message;
+    Message msg = makeMessage(id, message);
     m_messages.prepend(msg);
+    indexSender(msg);
     
-    // Rebuild index map (prepend shifts all indices)
-    rebuildIndexMap();
+    // Only the new row is indexed; existing rows keep their entries
+    indexRowsInserted(0, 1);
+    computeGroupFlags(0);
     
     endInsertRows();
     
@@ -194,11 +237,8 @@ void MessageModel::appendMessages(const QVariantList& messages)
     for (const QVariant& v : messages) {
         QVariantMap msgData = v.toMap();
         QString id = extractId(msgData);
-        if (!id.isEmpty() && !m_idToIndex.contains(id)) {
-            Message msg;
-            msg.id = id;
-            msg.data = msgData;
-            toAdd.append(msg);
+        if (!id.isEmpty() && !m_index.contains(id)) {
+            toAdd.append(makeMessage(id, msgData));
         }
     }
     
@@ -212,60 +252,144 @@ void MessageModel::appendMessages(const QVariantList& messages)
     beginInsertRows(QModelIndex(), first, last);
     
     for (const Message& msg : toAdd) {
-        m_idToIndex[msg.id] = m_messages.count();
         m_messages.append(msg);
+        indexSender(msg);
+    }
+    indexRowsInserted(first, toAdd.count());
+    for (int i = first; i <= last; ++i) {
+        computeGroupFlags(i);
     }
     
     endInsertRows();
     
+    // The previously oldest row now has a predecessor
+    refreshGroupFlags(first - 1);
+    
     emit countChanged();
     for (const Message& msg : toAdd) {
         emit messageAdded(msg.id, false);
     }
+    
+    // Scrolled far back: let go of the newest rows
+    trimWindow(true);
+}
+
+void MessageModel::prependMessages(const QVariantList& messages, bool hasNewer)
+{
+    // Filter out duplicates
+    QList<Message> toAdd;
+    for (const QVariant& v : messages) {
+        QVariantMap msgData = v.toMap();
+        QString id = extractId(msgData);
+        if (!id.isEmpty() && !m_index.contains(id)) {
+            toAdd.append(makeMessage(id, msgData));
+        }
+    }
+    
+    if (!toAdd.isEmpty()) {
+        beginInsertRows(QModelIndex(), 0, toAdd.count() - 1);
+        
+        // Chunk is newest-first, so insert its oldest row first
+        for (int i = toAdd.count() - 1; i >= 0; --i) {
+            m_messages.prepend(toAdd.at(i));
+            indexSender(toAdd.at(i));
+        }
+        indexRowsInserted(0, toAdd.count());
+        for (int i = 0; i < toAdd.count(); ++i) {
+            computeGroupFlags(i);
+        }
+        
+        endInsertRows();
+        
+        emit countChanged();
+        for (const Message& msg : toAdd) {
+            emit messageAdded(msg.id, false);
+        }
+        
+        // Scrolling back down: let go of the oldest rows
+        trimWindow(false);
+    }
+    
+    setHasNewerMessages(hasNewer);
+}
+
+void MessageModel::replaceMessages(const QVariantList& messages)
+{
+    beginResetModel();
+    
+    m_messages.clear();
+    m_index.clear();
+    m_senderIndex.clear();
+    for (const QVariant& v : messages) {
+        QVariantMap msgData = v.toMap();
+        QString id = extractId(msgData);
+        if (id.isEmpty() || m_index.contains(id))
+            continue;
+        
+        Message msg = makeMessage(id, msgData);
+        m_index.setRow(id, m_messages.count());
+        m_messages.append(msg);
+        indexSender(msg);
+    }
+    for (int i = 0; i < m_messages.count(); ++i) {
+        computeGroupFlags(i);
+    }
+    
+    endResetModel();
+    
+    emit countChanged();
+    setHasNewerMessages(false);
 }
 
 void MessageModel::replaceTempMessage(const QString& tempId, const QVariantMap& realMessage)
 {
-    if (!m_idToIndex.contains(tempId)) {
+    int index = m_index.rowOf(tempId);
+    if (index < 0) {
         // Temp message not found, just prepend the real one
         prependMessage(realMessage);
         return;
     }
     
-    int index = m_idToIndex[tempId];
     QString newId = extractId(realMessage);
     
     // Check if real message already exists (race condition)
-    if (m_idToIndex.contains(newId) && newId != tempId) {
+    if (m_index.contains(newId) && newId != tempId) {
         // Just remove the temp message
         deleteMessage(tempId);
         return;
     }
     
     // Update in place - uses dataChanged which preserves scroll!
-    m_idToIndex.remove(tempId);
-    m_messages[index].id = newId;
-    m_messages[index].data = realMessage;
-    m_idToIndex[newId] = index;
+    m_index.remove(tempId);
+    unindexSender(m_messages.at(index));
+    m_messages[index] = makeMessage(newId, realMessage);
+    indexSender(m_messages.at(index));
+    m_index.setRow(newId, index);
+    computeGroupFlags(index);
     
     // Emit dataChanged for the affected row
-    QModelIndex modelIndex = createIndex(index, 0);
-    emit dataChanged(modelIndex, modelIndex);
+    notifyRowChanged(index);
+    
+    // Server timestamp may differ from the optimistic one
+    refreshGroupFlags(index - 1);
     
     emit messageUpdated(newId);
 }
 
 bool MessageModel::updateMessage(const QString& messageId, const QVariantMap& updatedMessage)
 {
-    if (!m_idToIndex.contains(messageId))
+    int index = m_index.rowOf(messageId);
+    if (index < 0)
         return false;
-    
-    int index = m_idToIndex[messageId];
-    m_messages[index].data = updatedMessage;
+
+    unindexSender(m_messages.at(index));
+    m_messages[index] = makeMessage(messageId, updatedMessage);
+    indexSender(m_messages.at(index));
+    computeGroupFlags(index);
     
     // Emit dataChanged - this is the key to updating without scroll reset!
-    QModelIndex modelIndex = createIndex(index, 0);
-    emit dataChanged(modelIndex, modelIndex);
+    notifyRowChanged(index);
+    refreshGroupFlags(index - 1);
     
     emit messageUpdated(messageId);
     return true;
@@ -273,34 +397,37 @@ bool MessageModel::updateMessage(const QString& messageId, const QVariantMap& up
 
 bool MessageModel::updateReactions(const QString& messageId, const QVariantList& reactions)
 {
-    if (!m_idToIndex.contains(messageId))
+    int index = m_index.rowOf(messageId);
+    if (index < 0)
         return false;
-    
-    int index = m_idToIndex[messageId];
+
     m_messages[index].data["reactions"] = reactions;
     
     // Only emit change for reactions role - more efficient
-    QModelIndex modelIndex = createIndex(index, 0);
     QVector<int> roles;
     roles << ReactionsRole;
-    emit dataChanged(modelIndex, modelIndex, roles);
+    notifyRowChanged(index, roles);
     
     return true;
 }
 
 bool MessageModel::deleteMessage(const QString& messageId)
 {
-    if (!m_idToIndex.contains(messageId))
+    int index = m_index.rowOf(messageId);
+    if (index < 0)
         return false;
     
-    int index = m_idToIndex[messageId];
-    
     // For BottomToTop ListView with delegates, use full model reset
     // to avoid crashes during delegate cleanup
     beginResetModel();
     
+    m_index.remove(messageId);
+    unindexSender(m_messages.at(index));
     m_messages.removeAt(index);
-    rebuildIndexMap();
+    indexRowsRemoved(index, 1);
+    
+    // The row below the deleted one is now grouped against a different row
+    computeGroupFlags(index - 1);
     
     endResetModel();
     
@@ -320,20 +447,21 @@ void MessageModel::deleteMessageDeferred(const QString& messageId)
 
 bool MessageModel::hasMessage(const QString& messageId) const
 {
-    return m_idToIndex.contains(messageId);
+    return m_index.contains(messageId);
 }
 
 QVariantMap MessageModel::getMessage(const QString& messageId) const
 {
-    if (!m_idToIndex.contains(messageId))
+    int index = m_index.rowOf(messageId);
+    if (index < 0)
         return QVariantMap();
     
-    return m_messages.at(m_idToIndex[messageId]).data;
+    return m_messages.at(index).data;
 }
 
 int MessageModel::indexOfMessage(const QString& messageId) const
 {
-    return m_idToIndex.value(messageId, -1);
+    return m_index.rowOf(messageId);
 }
 
 QString MessageModel::oldestMessageId() const
@@ -372,17 +500,15 @@ void MessageModel::setUserProfileCache(UserProfileCache* cache)
     
     if (m_userProfileCache) {
         // When profile cache updates, notify relevant rows
+        // Profiles tend to resolve in bursts, so collect them and refresh
+        // the affected rows once per event loop pass
         connect(m_userProfileCache, &UserProfileCache::profileLoaded,
                 this, [this](const QString& userId) {
-            // Find all messages from this sender and update
-            QVector<int> roles;
-            roles << SenderNameRole << SenderAvatarRole;
-            
-            for (int i = 0; i < m_messages.count(); ++i) {
-                if (m_messages[i].data.value("senderId").toString() == userId) {
-                    emit dataChanged(createIndex(i, 0), createIndex(i, 0), roles);
-                }
-            }
+            if (!m_senderIndex.contains(userId))
+                return;
+            m_pendingProfileSenders.insert(userId);
+            if (!m_profileUpdateTimer->isActive())
+                m_profileUpdateTimer->start();
         });
     }
 }
@@ -391,12 +517,113 @@ void MessageModel::setUserProfileCache(UserProfileCache* cache)
 // Private Helpers
 // ============================================================================
 
-void MessageModel::rebuildIndexMap()
+void MessageModel::indexRowsInserted(int row, int count)
 {
-    m_idToIndex.clear();
-    for (int i = 0; i < m_messages.count(); ++i) {
-        m_idToIndex[m_messages[i].id] = i;
+    m_index.rowsInserted(row, count, m_messages.count(),
+                         [this](int i) { return m_messages.at(i).id; });
+}
+
+void MessageModel::indexRowsRemoved(int row, int count)
+{
+    m_index.rowsRemoved(row, count, m_messages.count(),
+                        [this](int i) { return m_messages.at(i).id; });
+}
+
+void MessageModel::trimWindow(bool dropNewest)
+{
+    if (m_isDMMode || m_windowSize <= 0 || m_messages.count() <= m_windowSize)
+        return;
+    
+    int excess = m_messages.count() - m_windowSize;
+    
+    if (dropNewest) {
+        // Newest rows sit at the front (index 0 = bottom of the view)
+        beginRemoveRows(QModelIndex(), 0, excess - 1);
+        for (int i = 0; i < excess; ++i) {
+            m_index.remove(m_messages.at(i).id);
+            unindexSender(m_messages.at(i));
+        }
+        m_messages.erase(m_messages.begin(), m_messages.begin() + excess);
+        indexRowsRemoved(0, excess);
+        endRemoveRows();
+        
+        setHasNewerMessages(true);
+    } else {
+        // Oldest rows sit at the back - no surviving index shifts
+        int first = m_messages.count() - excess;
+        beginRemoveRows(QModelIndex(), first, m_messages.count() - 1);
+        for (int i = first; i < m_messages.count(); ++i) {
+            m_index.remove(m_messages.at(i).id);
+            unindexSender(m_messages.at(i));
+        }
+        m_messages.erase(m_messages.begin() + first, m_messages.end());
+        endRemoveRows();
+        
+        // New oldest row lost its predecessor
+        refreshGroupFlags(m_messages.count() - 1);
+        
+        setHasMoreMessages(true);
+    }
+    
+    emit countChanged();
+    qDebug() << "[MessageModel] Window trimmed" << excess << (dropNewest ? "newest" : "oldest") << "rows";
+}
+
+MessageModel::Message MessageModel::makeMessage(const QString& id, const QVariantMap& data)
+{
+    Message msg;
+    msg.id = id;
+    msg.senderId = data.value("senderId").toString();
+    msg.data = data;
+    
+    QString createdAt = data.value("createdAt").toString();
+    QDateTime time = QDateTime::fromString(createdAt, Qt::ISODate);
+    if (!time.isValid()) {
+        // Try with milliseconds format
+        time = QDateTime::fromString(createdAt, Qt::ISODateWithMs);
+    }
+    if (time.isValid()) {
+        msg.createdAt = time.toMSecsSinceEpoch();
+        msg.day = time.toLocalTime().date().toJulianDay();
+    }
+    return msg;
+}
+
+void MessageModel::indexSender(const Message& msg)
+{
+    if (!msg.senderId.isEmpty())
+        m_senderIndex[msg.senderId].insert(msg.id);
+}
+
+void MessageModel::unindexSender(const Message& msg)
+{
+    QHash<QString, QSet<QString>>::iterator it = m_senderIndex.find(msg.senderId);
+    if (it == m_senderIndex.end())
+        return;
+    
+    it.value().remove(msg.id);
+    if (it.value().isEmpty())
+        m_senderIndex.erase(it);
+}
+
+void MessageModel::flushProfileUpdates()
+{
+    QVector<int> rows;
+    for (const QString& senderId : m_pendingProfileSenders) {
+        QHash<QString, QSet<QString>>::const_iterator it = m_senderIndex.constFind(senderId);
+        if (it == m_senderIndex.constEnd())
+            continue;
+        for (const QString& id : it.value()) {
+            int row = m_index.rowOf(id);
+            if (row >= 0)
+                rows.append(row);
+        }
     }
+    m_pendingProfileSenders.clear();
+    
+    QVector<int> roles;
+    roles << SenderNameRole << SenderAvatarRole;
+    emitRowRuns(rows, roles);
 }
 
 QString MessageModel::extractId(const QVariantMap& message)
@@ -439,40 +666,140 @@ QString MessageModel::getSenderAvatar(const QString& senderId) const
 
 bool MessageModel::shouldShowAvatar(int index) const
 {
-    // First message (last in reversed list) always shows avatar
-    if (index >= m_messages.count() - 1) {
+    if (index < 0 || index >= m_messages.count())
         return true;
-    }
+    return (m_messages.at(index).groupFlags & ShowAvatarFlag) != 0;
+}
 
-    // Get current and previous messages
-    const QVariantMap& currentMsg = m_messages.at(index).data;
-    const QVariantMap& prevMsg = m_messages.at(index + 1).data;  // Previous in time (above in view)
+void MessageModel::setFirstUnreadMessageId(const QString& messageId)
+{
+    if (m_firstUnreadMessageId == messageId)
+        return;
+    
+    int oldRow = m_index.rowOf(m_firstUnreadMessageId);
+    m_firstUnreadMessageId = messageId;
+    int newRow = m_index.rowOf(messageId);
+    
+    QVector<int> roles;
+    roles << IsFirstUnreadRole;
+    if (oldRow >= 0)
+        emit dataChanged(createIndex(oldRow, 0), createIndex(oldRow, 0), roles);
+    if (newRow >= 0)
+        emit dataChanged(createIndex(newRow, 0), createIndex(newRow, 0), roles);
+}
 
-    // Show avatar if different sender
-    QString currentSender = currentMsg.value("senderId").toString();
-    QString prevSender = prevMsg.value("senderId").toString();
-    if (currentSender != prevSender) {
-        return true;
+bool MessageModel::computeGroupFlags(int row)
+{
+    if (row < 0 || row >= m_messages.count())
+        return false;
+    
+    Message& msg = m_messages[row];
+    quint8 flags = 0;
+    
+    if (row == m_messages.count() - 1) {
+        // Oldest loaded message always starts a group
+        flags = ShowAvatarFlag | DayStartFlag;
+    } else {
+        const Message& prev = m_messages.at(row + 1);  // Previous in time (above in view)
+        
+        // Show avatar if different sender
+        if (msg.senderId != prev.senderId)
+            flags |= ShowAvatarFlag;
+        
+        if (msg.createdAt != 0 && prev.createdAt != 0) {
+            // Show avatar if more than 5 minutes apart
+            if (msg.createdAt - prev.createdAt > 5 * 60 * 1000)
+                flags |= ShowAvatarFlag;
+            if (msg.day != prev.day)
+                flags |= DayStartFlag;
+        }
     }
+    
+    if (msg.groupFlags == flags)
+        return false;
+    msg.groupFlags = flags;
+    return true;
+}
+
+void MessageModel::refreshGroupFlags(int row)
+{
+    if (!computeGroupFlags(row))
+        return;
+    
+    QVector<int> roles;
+    roles << ShowAvatarRole << IsDayStartRole;
+    notifyRowChanged(row, roles);
+}
 
-    // Show avatar if more than 5 minutes apart
-    QDateTime currentTime = QDateTime::fromString(currentMsg.value("createdAt").toString(), Qt::ISODate);
-    QDateTime prevTime = QDateTime::fromString(prevMsg.value("createdAt").toString(), Qt::ISODate);
+void MessageModel::beginBatch()
+{
+    m_batchDepth++;
+}
 
-    if (!currentTime.isValid() || !prevTime.isValid()) {
-        // Try with milliseconds format
-        currentTime = QDateTime::fromString(currentMsg.value("createdAt").toString(), Qt::ISODateWithMs);
-        prevTime = QDateTime::fromString(prevMsg.value("createdAt").toString(), Qt::ISODateWithMs);
+void MessageModel::endBatch()
+{
+    if (m_batchDepth == 0 || --m_batchDepth > 0)
+        return;
+    
+    QVector<int> rows;
+    rows.reserve(m_batchChangedIds.size());
+    for (const QString& id : m_batchChangedIds) {
+        int row = m_index.rowOf(id);
+        if (row >= 0)
+            rows.append(row);
     }
+    
+    QVector<int> roles;
+    if (!m_batchAllRoles) {
+        for (int role : m_batchRoles)
+            roles.append(role);
+    }
+    
+    m_batchChangedIds.clear();
+    m_batchRoles.clear();
+    m_batchAllRoles = false;
+    
+    emitRowRuns(rows, roles);
+}
 
-    if (currentTime.isValid() && prevTime.isValid()) {
-        qint64 diffMs = currentTime.toMSecsSinceEpoch() - prevTime.toMSecsSinceEpoch();
-        if (diffMs > 5 * 60 * 1000) {  // 5 minutes
-            return true;
-        }
+void MessageModel::notifyRowChanged(int row, const QVector<int>& roles)
+{
+    const QString& id = m_messages.at(row).id;
+    if (m_batchDepth == 0 || id.isEmpty()) {
+        emit dataChanged(createIndex(row, 0), createIndex(row, 0), roles);
+        return;
     }
+    
+    // Rows may still move within the batch, so remember the ID
+    m_batchChangedIds.insert(id);
+    if (roles.isEmpty()) {
+        m_batchAllRoles = true;
+    } else {
+        for (int role : roles)
+            m_batchRoles.insert(role);
+    }
+}
 
-    return false;
+void MessageModel::emitRowRuns(QVector<int> rows, const QVector<int>& roles)
+{
+    if (rows.isEmpty())
+        return;
+    
+    // One dataChanged per contiguous run of rows (runs of the same sender
+    // are common in chat, so this is usually a handful of signals)
+    std::sort(rows.begin(), rows.end());
+    
+    int runStart = rows.first();
+    int runEnd = runStart;
+    for (int i = 1; i < rows.count(); ++i) {
+        if (rows.at(i) == runEnd + 1) {
+            runEnd = rows.at(i);
+            continue;
+        }
+        emit dataChanged(createIndex(runStart, 0), createIndex(runEnd, 0), roles);
+        runStart = runEnd = rows.at(i);
+    }
+    emit dataChanged(createIndex(runStart, 0), createIndex(runEnd, 0), roles);
 }
 
 bool MessageModel::addRealMessage(const QVariantMap& message)
@@ -484,7 +811,7 @@ bool MessageModel::addRealMessage(const QVariantMap& message)
     }
 
     // Check if real message already exists (duplicate from Socket.IO vs HTTP)
-    if (m_idToIndex.contains(msgId)) {
+    if (m_index.contains(msgId)) {
         qDebug() << "[MessageModel] Duplicate message ignored:" << msgId;
         return false;
     }
@@ -5,9 +5,13 @@
 #include <QVariantMap>
 #include <QDateTime>
 #include <QHash>
+#include <QSet>
 
-// Forward declaration
+#include "rowindex.h"
+
+// Forward declarations
 class UserProfileCache;
+class QTimer;
 
 /**
  * @brief High-performance C++ model for chat messages.
@@ -28,6 +32,12 @@ class UserProfileCache;
  * 
  * 4. THREAD SAFETY: Model operations can be safely called from any thread.
  * 
+ * 5. BOUNDED MEMORY: Channel history is a sliding window of at most
+ *    windowSize() rows. Paging older history in drops the newest rows
+ *    (hasNewerMessages becomes true) and paging newer rows back in via
+ *    prependMessages() drops the oldest, so long scroll-back sessions use
+ *    constant memory. Dropped rows are re-read from MessageCache or the API.
+ * 
  * Usage in QML:
  *   ListView {
  *       model: SerchatAPI.messageModel
@@ -45,6 +55,7 @@ class MessageModel : public QAbstractListModel {
     // Properties exposed to QML
     Q_PROPERTY(int count READ count NOTIFY countChanged)
     Q_PROPERTY(bool hasMoreMessages READ hasMoreMessages WRITE setHasMoreMessages NOTIFY hasMoreMessagesChanged)
+    Q_PROPERTY(bool hasNewerMessages READ hasNewerMessages NOTIFY hasNewerMessagesChanged)
     Q_PROPERTY(QString channelId READ channelId NOTIFY channelIdChanged)
     Q_PROPERTY(QString serverId READ serverId NOTIFY serverIdChanged)
     Q_PROPERTY(bool isDMMode READ isDMMode NOTIFY isDMModeChanged)
@@ -66,6 +77,9 @@ public:
         ReactionsRole,              // reactions array
         AttachmentsRole,            // attachments array
         IsTempMessageRole,          // true if this is a pending optimistic message
+        ShowAvatarRole,             // first of a sender's run (precomputed)
+        IsDayStartRole,             // first message of a calendar day (precomputed)
+        IsFirstUnreadRole,          // "NEW MESSAGES" divider goes above this row
     };
     Q_ENUM(MessageRoles)
 
@@ -87,6 +101,15 @@ public:
     int count() const { return m_messages.count(); }
     bool hasMoreMessages() const { return m_hasMoreMessages; }
     void setHasMoreMessages(bool hasMore);
+    bool hasNewerMessages() const { return m_hasNewerMessages; }
+    void setHasNewerMessages(bool hasNewer);
+    
+    /**
+     * @brief Maximum number of resident rows for channels (default: 300).
+     * DMs are not windowed. 0 disables the limit.
+     */
+    int windowSize() const { return m_windowSize; }
+    void setWindowSize(int rows);
     QString channelId() const { return m_channelId; }
     QString serverId() const { return m_serverId; }
     bool isDMMode() const { return m_isDMMode; }
@@ -124,6 +147,20 @@ public:
      */
     Q_INVOKABLE void appendMessages(const QVariantList& messages);
     
+    /**
+     * @brief Insert a chunk of newer messages (newest-first) at the bottom.
+     * Used to page rows dropped by the window back in; the oldest rows are
+     * dropped in turn if the window overflows.
+     * @param hasNewer Whether more rows exist between this chunk and the live end
+     */
+    Q_INVOKABLE void prependMessages(const QVariantList& messages, bool hasNewer);
+    
+    /**
+     * @brief Replace all messages (newest-first) in a single model reset.
+     * Used when a fresh page supersedes messages painted from the cache.
+     */
+    Q_INVOKABLE void replaceMessages(const QVariantList& messages);
+    
     /**
      * @brief Replace a temporary message with the real server response.
      * Preserves scroll position by using dataChanged instead of remove+insert.
@@ -195,8 +232,24 @@ public:
      * - It's the first message (last in the reversed list)
      * - The sender is different from the previous message
      * - More than 5 minutes have passed since the previous message
+     * Precomputed on insert; delegates should bind to the showAvatar role.
      */
     Q_INVOKABLE bool shouldShowAvatar(int index) const;
+    
+    /**
+     * @brief Set the message the "NEW MESSAGES" divider sits above.
+     * Exposed per row through the isFirstUnread role. Empty clears it.
+     */
+    void setFirstUnreadMessageId(const QString& messageId);
+
+    /**
+     * @brief Coalesce row updates until the matching endBatch().
+     * Edits and reaction changes inside a batch are collected by message ID
+     * and emitted as one dataChanged per contiguous run of rows at the end.
+     * Inserts and removals still signal immediately. Batches nest.
+     */
+    void beginBatch();
+    void endBatch();
 
     /**
      * @brief Add a real message, replacing any matching temp message.
@@ -232,6 +285,7 @@ public:
 signals:
     void countChanged();
     void hasMoreMessagesChanged();
+    void hasNewerMessagesChanged();
     void channelIdChanged();
     void serverIdChanged();
     void isDMModeChanged();
@@ -249,14 +303,42 @@ private:
      */
     struct Message {
         QString id;
+        QString senderId;  // Copied out of data for the sender index
         QVariantMap data;
+        
+        // Parsed once on insert for the grouping flags
+        qint64 createdAt = 0;  // ms since epoch, 0 if unknown
+        qint64 day = 0;        // Local calendar day (Julian day number)
+        quint8 groupFlags = 0;
+    };
+    
+    enum GroupFlag {
+        ShowAvatarFlag = 0x01,
+        DayStartFlag   = 0x02
     };
     
     // Message storage - QList provides fast prepend/append
     QList<Message> m_messages;
     
-    // Fast ID -> index lookup (O(1) instead of O(n))
-    QHash<QString, int> m_idToIndex;
+    // Fast ID -> row lookup; prepends and front trims don't renumber rows
+    RowIndex m_index;
+    
+    // senderId -> IDs of that sender's messages, so a resolved profile
+    // only touches its own rows (IDs, not rows, since rows shift)
+    QHash<QString, QSet<QString>> m_senderIndex;
+    
+    // Profiles resolved since the last flush; rows are refreshed once per
+    // event loop pass with coalesced range dataChanged signals
+    QSet<QString> m_pendingProfileSenders;
+    QTimer* m_profileUpdateTimer;
+    
+    // Update batching (see beginBatch)
+    int m_batchDepth = 0;
+    QSet<QString> m_batchChangedIds;
+    QSet<int> m_batchRoles;
+    bool m_batchAllRoles = false;
+    
+    QString m_firstUnreadMessageId;
     
     // User profile cache for sender name/avatar resolution (shared with SerchatAPI)
     UserProfileCache* m_userProfileCache;
@@ -267,13 +349,35 @@ private:
     QString m_dmRecipientId;
     bool m_isDMMode;
     bool m_hasMoreMessages;
+    bool m_hasNewerMessages;  // Newest rows were dropped by the window
+    int m_windowSize;
+    
+    // Helpers to keep m_index in step with structural changes
+    void indexRowsInserted(int row, int count);
+    void indexRowsRemoved(int row, int count);
     
-    // Helper to rebuild index map after structural changes
-    void rebuildIndexMap();
+    // Drop rows beyond the window, from the newest or the oldest end
+    void trimWindow(bool dropNewest);
     
     // Helper to extract message ID from data
     static QString extractId(const QVariantMap& message);
     
+    // Sender index maintenance
+    static Message makeMessage(const QString& id, const QVariantMap& data);
+    void indexSender(const Message& msg);
+    void unindexSender(const Message& msg);
+    void flushProfileUpdates();
+    
+    // Emit dataChanged for a row now, or defer it while a batch is open
+    void notifyRowChanged(int row, const QVector<int>& roles = QVector<int>());
+    void emitRowRuns(QVector<int> rows, const QVector<int>& roles);
+    
+    // Grouping flags. Row i is grouped against row i + 1 (previous in time),
+    // so an insert or delete only affects the rows themselves and the row
+    // just below them.
+    bool computeGroupFlags(int row);
+    void refreshGroupFlags(int row);
+    
     // Helper to get sender name from profile cache
     QString getSenderName(const QString& senderId) const;
     QString getSenderAvatar(const QString& senderId) const;
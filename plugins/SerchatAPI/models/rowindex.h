@@ -0,0 +1,118 @@
+#ifndef ROWINDEX_H
+#define ROWINDEX_H
+
+#include <QHash>
+#include <QString>
+
+/**
+ * @brief ID -> row lookup for list models that survives structural changes cheaply.
+ *
+ * Each ID maps to a sequence number and row = sequence - base. Inserting or
+ * removing rows at the front only moves the base, so prepends (new chat
+ * messages) and front trims are O(k) in the rows touched instead of
+ * renumbering every row. Inserts and removals in the middle renumber
+ * whichever side of the change is shorter.
+ *
+ * The index doesn't own the rows. Structural methods take an `idAt(int row)`
+ * accessor that returns the ID stored at a row *after* the change; rows
+ * with an empty ID are simply not indexed.
+ */
+class RowIndex {
+public:
+    void clear()
+    {
+        m_seq.clear();
+        m_base = 0;
+    }
+
+    bool contains(const QString& id) const { return m_seq.contains(id); }
+
+    /**
+     * @brief Row of an ID, or -1 if not indexed.
+     */
+    int rowOf(const QString& id) const
+    {
+        QHash<QString, qint64>::const_iterator it = m_seq.constFind(id);
+        return it == m_seq.constEnd() ? -1 : static_cast<int>(it.value() - m_base);
+    }
+
+    /**
+     * @brief Point an ID at a row (no other rows move).
+     */
+    void setRow(const QString& id, int row)
+    {
+        if (!id.isEmpty())
+            m_seq.insert(id, m_base + row);
+    }
+
+    void remove(const QString& id) { m_seq.remove(id); }
+
+    void reserve(int size) { m_seq.reserve(size); }
+
+    /**
+     * @brief Index `total` rows from scratch.
+     */
+    template<typename IdAt>
+    void rebuild(int total, IdAt idAt)
+    {
+        clear();
+        m_seq.reserve(total);
+        for (int i = 0; i < total; ++i)
+            setRow(idAt(i), i);
+    }
+
+    /**
+     * @brief `count` rows were inserted at `row`; `total` is the new row count.
+     * Indexes the new rows and shifts the shorter side of the old ones.
+     */
+    template<typename IdAt>
+    void rowsInserted(int row, int count, int total, IdAt idAt)
+    {
+        int after = total - row - count;
+        if (row <= after) {
+            // Rows in front keep their row but need one base lower
+            m_base -= count;
+            for (int i = 0; i < row; ++i)
+                setRow(idAt(i), i);
+        } else {
+            for (int i = row + count; i < total; ++i)
+                setRow(idAt(i), i);
+        }
+        for (int i = row; i < row + count; ++i)
+            setRow(idAt(i), i);
+    }
+
+    /**
+     * @brief `count` rows were removed at `row`; `total` is the new row count.
+     * The removed IDs must already have been remove()d.
+     */
+    template<typename IdAt>
+    void rowsRemoved(int row, int count, int total, IdAt idAt)
+    {
+        int after = total - row;
+        if (row <= after) {
+            m_base += count;
+            for (int i = 0; i < row; ++i)
+                setRow(idAt(i), i);
+        } else {
+            for (int i = row; i < total; ++i)
+                setRow(idAt(i), i);
+        }
+    }
+
+    /**
+     * @brief Renumber rows [first, last] in place (e.g. after a move).
+     */
+    template<typename IdAt>
+    void renumber(int first, int last, IdAt idAt)
+    {
+        for (int i = first; i <= last; ++i)
+            setRow(idAt(i), i);
+    }
+
+private:
+    QHash<QString, qint64> m_seq;
+    qint64 m_base = 0;
+};
+
+#endif // ROWINDEX_H
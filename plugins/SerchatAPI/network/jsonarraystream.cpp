@@ -0,0 +1,129 @@
+#include "jsonarraystream.h"
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+namespace {
+inline bool isJsonSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+}
+
+void JsonArrayStream::feed(const QByteArray& chunk, QByteArrayList& elements)
+{
+    if (m_state == Done || m_state == Failed) {
+        return;
+    }
+
+    m_buffer.append(chunk);
+    const char* data = m_buffer.constData();
+    const int size = m_buffer.size();
+    int i = m_scan;
+    int start = 0;
+
+    if (m_state == Start) {
+        while (i < size && isJsonSpace(data[i])) {
+            ++i;
+        }
+        if (i == size) {
+            m_buffer.clear();
+            m_scan = 0;
+            return;
+        }
+        if (data[i] != '[') {
+            m_state = Failed;
+            m_buffer.clear();
+            return;
+        }
+        m_state = InArray;
+        start = ++i;
+    }
+
+    for (; i < size; ++i) {
+        char c = data[i];
+
+        if (m_inString) {
+            if (m_escape) {
+                m_escape = false;
+            } else if (c == '\\') {
+                m_escape = true;
+            } else if (c == '"') {
+                m_inString = false;
+            }
+            continue;
+        }
+
+        switch (c) {
+        case '"':
+            m_inString = true;
+            break;
+        case '{':
+        case '[':
+            ++m_depth;
+            break;
+        case '}':
+            --m_depth;
+            break;
+        case ']':
+            if (m_depth == 0) {
+                endElement(start, i, elements);
+                m_state = Done;
+                m_buffer.clear();
+                m_scan = 0;
+                return;
+            }
+            --m_depth;
+            break;
+        case ',':
+            if (m_depth == 0) {
+                endElement(start, i, elements);
+                start = i + 1;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Keep only the unfinished element
+    m_buffer.remove(0, start);
+    m_scan = size - start;
+}
+
+void JsonArrayStream::endElement(int start, int end, QByteArrayList& elements)
+{
+    QByteArray element = m_buffer.mid(start, end - start).trimmed();
+    if (!element.isEmpty()) {
+        elements.append(element);
+    }
+}
+
+QVariantList JsonArrayStream::parseElements(const QByteArrayList& elements, bool* ok)
+{
+    if (ok) {
+        *ok = true;
+    }
+    if (elements.isEmpty()) {
+        return QVariantList();
+    }
+
+    // One parse for the whole batch instead of one document per element
+    QByteArray json;
+    json.reserve(elements.size() * 256);
+    json.append('[');
+    json.append(elements.join(','));
+    json.append(']');
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+    if (error.error != QJsonParseError::NoError || !doc.isArray()) {
+        qWarning() << "[JsonArrayStream] Malformed element batch:" << error.errorString();
+        if (ok) {
+            *ok = false;
+        }
+        return QVariantList();
+    }
+
+    return doc.array().toVariantList();
+}
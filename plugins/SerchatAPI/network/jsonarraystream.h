@@ -0,0 +1,51 @@
+#ifndef JSONARRAYSTREAM_H
+#define JSONARRAYSTREAM_H
+
+#include <QByteArray>
+#include <QByteArrayList>
+#include <QVariantList>
+
+/**
+ * @brief Splits a top-level JSON array into its elements as bytes arrive.
+ *
+ * feed() takes chunks in any size (e.g. from QNetworkReply::readyRead) and
+ * hands back the raw bytes of every element completed so far; only the
+ * unfinished tail is kept. It tracks strings, escapes and nesting, but
+ * doesn't validate the elements - parseElements() does that when turning a
+ * batch of them into variants.
+ *
+ *     JsonArrayStream stream;
+ *     QByteArrayList elements;
+ *     stream.feed(reply->readAll(), elements);
+ *     QVariantList items = JsonArrayStream::parseElements(elements, &ok);
+ */
+class JsonArrayStream {
+public:
+    enum State {
+        Start,      // Nothing but whitespace seen yet
+        InArray,    // Inside the top-level array
+        Done,       // Closing bracket seen; anything after is ignored
+        Failed      // Body isn't a JSON array
+    };
+
+    State state() const { return m_state; }
+
+    /// Scan the next chunk; completed elements are appended to `elements`
+    void feed(const QByteArray& chunk, QByteArrayList& elements);
+
+    /// Parse raw elements in one go. Returns an empty list and sets *ok to
+    /// false if any of them isn't valid JSON.
+    static QVariantList parseElements(const QByteArrayList& elements, bool* ok);
+
+private:
+    void endElement(int start, int end, QByteArrayList& elements);
+
+    State m_state = Start;
+    QByteArray m_buffer;     // Unfinished element, starting at its first byte
+    int m_scan = 0;          // Next byte of m_buffer to look at
+    int m_depth = 0;         // Nesting inside the current element
+    bool m_inString = false;
+    bool m_escape = false;
+};
+
+#endif // JSONARRAYSTREAM_H
@@ -0,0 +1,318 @@
+#include "jsonwriter.h"
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QLocale>
+#include <QStringList>
+#include <QtNumeric>
+
+namespace {
+// Large enough for a typical control frame so most writers never regrow
+const int kInitialCapacity = 512;
+
+const char kHexDigits[] = "0123456789abcdef";
+}
+
+JsonWriter::JsonWriter()
+    : m_afterKey(false)
+{
+    // A reserved QByteArray keeps its capacity across resize(0)
+    m_buffer.reserve(kInitialCapacity);
+}
+
+void JsonWriter::reset()
+{
+    m_buffer.resize(0);
+    m_first.clear();
+    m_afterKey = false;
+}
+
+void JsonWriter::separator()
+{
+    if (m_afterKey) {
+        m_afterKey = false;
+        return;
+    }
+    if (m_first.isEmpty()) {
+        return;
+    }
+    if (m_first.last()) {
+        m_first.last() = false;
+    } else {
+        m_buffer.append(',');
+    }
+}
+
+void JsonWriter::beginObject()
+{
+    separator();
+    m_buffer.append('{');
+    m_first.append(true);
+}
+
+void JsonWriter::endObject()
+{
+    m_first.removeLast();
+    m_buffer.append('}');
+}
+
+void JsonWriter::beginArray()
+{
+    separator();
+    m_buffer.append('[');
+    m_first.append(true);
+}
+
+void JsonWriter::endArray()
+{
+    m_first.removeLast();
+    m_buffer.append(']');
+}
+
+void JsonWriter::key(const char* name)
+{
+    separator();
+    m_buffer.append('"');
+    m_buffer.append(name);
+    m_buffer.append("\":", 2);
+    m_afterKey = true;
+}
+
+void JsonWriter::key(const QString& name)
+{
+    separator();
+    writeString(name);
+    m_buffer.append(':');
+    m_afterKey = true;
+}
+
+void JsonWriter::value(const QString& text)
+{
+    separator();
+    writeString(text);
+}
+
+void JsonWriter::value(const char* utf8)
+{
+    value(QString::fromUtf8(utf8));
+}
+
+void JsonWriter::value(bool flag)
+{
+    separator();
+    if (flag) {
+        m_buffer.append("true", 4);
+    } else {
+        m_buffer.append("false", 5);
+    }
+}
+
+void JsonWriter::value(int number)
+{
+    value(static_cast<qint64>(number));
+}
+
+void JsonWriter::value(qint64 number)
+{
+    separator();
+    m_buffer.append(QByteArray::number(number));
+}
+
+void JsonWriter::value(double number)
+{
+    if (!qIsFinite(number)) {
+        null();  // Same as QJsonValue
+        return;
+    }
+    separator();
+    m_buffer.append(QByteArray::number(number, 'g', QLocale::FloatingPointShortest));
+}
+
+void JsonWriter::value(const QVariant& variant)
+{
+    switch (static_cast<int>(variant.userType())) {
+    case QMetaType::UnknownType:
+        null();
+        break;
+    case QMetaType::Bool:
+        value(variant.toBool());
+        break;
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+        value(variant.toLongLong());
+        break;
+    case QMetaType::ULongLong:
+    case QMetaType::Double:
+    case QMetaType::Float:
+        value(variant.toDouble());
+        break;
+    case QMetaType::QString:
+        value(variant.toString());
+        break;
+    case QMetaType::QVariantMap: {
+        const QVariantMap map = variant.toMap();
+        beginObject();
+        for (QVariantMap::const_iterator it = map.constBegin(); it != map.constEnd(); ++it) {
+            key(it.key());
+            value(it.value());
+        }
+        endObject();
+        break;
+    }
+    case QMetaType::QVariantHash: {
+        const QVariantHash hash = variant.toHash();
+        beginObject();
+        for (QVariantHash::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+            key(it.key());
+            value(it.value());
+        }
+        endObject();
+        break;
+    }
+    case QMetaType::QVariantList: {
+        const QVariantList list = variant.toList();
+        beginArray();
+        for (const QVariant& item : list) {
+            value(item);
+        }
+        endArray();
+        break;
+    }
+    case QMetaType::QStringList: {
+        const QStringList list = variant.toStringList();
+        beginArray();
+        for (const QString& item : list) {
+            value(item);
+        }
+        endArray();
+        break;
+    }
+    default:
+        // Anything unusual converts the way QJsonObject::fromVariantMap would
+        value(QJsonValue::fromVariant(variant));
+        break;
+    }
+}
+
+void JsonWriter::value(const QJsonValue& json)
+{
+    switch (json.type()) {
+    case QJsonValue::Bool:
+        value(json.toBool());
+        break;
+    case QJsonValue::Double:
+        value(json.toDouble());
+        break;
+    case QJsonValue::String:
+        value(json.toString());
+        break;
+    case QJsonValue::Array: {
+        const QJsonArray array = json.toArray();
+        beginArray();
+        for (const QJsonValue& item : array) {
+            value(item);
+        }
+        endArray();
+        break;
+    }
+    case QJsonValue::Object: {
+        const QJsonObject object = json.toObject();
+        beginObject();
+        for (QJsonObject::const_iterator it = object.constBegin(); it != object.constEnd(); ++it) {
+            key(it.key());
+            value(it.value());
+        }
+        endObject();
+        break;
+    }
+    default:
+        null();
+        break;
+    }
+}
+
+void JsonWriter::null()
+{
+    separator();
+    m_buffer.append("null", 4);
+}
+
+void JsonWriter::raw(const QByteArray& json)
+{
+    separator();
+    m_buffer.append(json);
+}
+
+void JsonWriter::writeString(const QString& text)
+{
+    m_buffer.append('"');
+
+    const ushort* p = text.utf16();
+    const ushort* end = p + text.size();
+    while (p < end) {
+        ushort c = *p++;
+
+        if (c < 0x80) {
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                m_buffer.append(static_cast<char>(c));
+                continue;
+            }
+            m_buffer.append('\\');
+            switch (c) {
+            case '"':  m_buffer.append('"');  break;
+            case '\\': m_buffer.append('\\'); break;
+            case '\b': m_buffer.append('b');  break;
+            case '\f': m_buffer.append('f');  break;
+            case '\n': m_buffer.append('n');  break;
+            case '\r': m_buffer.append('r');  break;
+            case '\t': m_buffer.append('t');  break;
+            default:
+                m_buffer.append("u00", 3);
+                m_buffer.append(kHexDigits[c >> 4]);
+                m_buffer.append(kHexDigits[c & 0xf]);
+                break;
+            }
+        } else if (c < 0x800) {
+            m_buffer.append(static_cast<char>(0xc0 | (c >> 6)));
+            m_buffer.append(static_cast<char>(0x80 | (c & 0x3f)));
+        } else if (QChar::isHighSurrogate(c) && p < end && QChar::isLowSurrogate(*p)) {
+            uint ucs4 = QChar::surrogateToUcs4(c, *p++);
+            m_buffer.append(static_cast<char>(0xf0 | (ucs4 >> 18)));
+            m_buffer.append(static_cast<char>(0x80 | ((ucs4 >> 12) & 0x3f)));
+            m_buffer.append(static_cast<char>(0x80 | ((ucs4 >> 6) & 0x3f)));
+            m_buffer.append(static_cast<char>(0x80 | (ucs4 & 0x3f)));
+        } else {
+            if (QChar::isSurrogate(c)) {
+                c = QChar::ReplacementCharacter;  // Unpaired surrogate
+            }
+            m_buffer.append(static_cast<char>(0xe0 | (c >> 12)));
+            m_buffer.append(static_cast<char>(0x80 | ((c >> 6) & 0x3f)));
+            m_buffer.append(static_cast<char>(0x80 | (c & 0x3f)));
+        }
+    }
+
+    m_buffer.append('"');
+}
+
+void writeEnvelope(JsonWriter& w, const QString& eventType, const QByteArray& payload,
+                   const QString& replyTo, const QString& envelopeId, qint64 ts)
+{
+    w.reset();
+    w.beginObject();
+    w.field("id", envelopeId);
+    w.key("event");
+    w.beginObject();
+    w.field("type", eventType);
+    w.key("payload");
+    w.raw(payload.isEmpty() ? QByteArrayLiteral("{}") : payload);
+    w.endObject();
+    w.key("meta");
+    w.beginObject();
+    if (!replyTo.isEmpty()) {
+        w.field("replyTo", replyTo);
+    }
+    w.field("ts", ts);
+    w.endObject();
+    w.endObject();
+}
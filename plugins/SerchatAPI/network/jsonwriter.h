@@ -0,0 +1,87 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVariant>
+#include <QVarLengthArray>
+
+class QJsonValue;
+
+/**
+ * @brief Streaming compact-JSON writer into a reusable UTF-8 buffer.
+ *
+ * Used for outbound socket envelopes so no QJsonObject tree, variant
+ * conversion or intermediate document is built per frame. Strings are
+ * escaped and UTF-8 encoded straight from QString; reset() keeps the
+ * buffer's capacity, so a long-lived writer stops allocating once it has
+ * seen its largest frame.
+ *
+ * The writer trusts its caller: keys and values must be written in a
+ * valid order (key() before every value inside an object).
+ *
+ *     JsonWriter w;
+ *     w.beginObject();
+ *     w.field("channelId", channelId);
+ *     w.endObject();
+ *     send(w.data());
+ */
+class JsonWriter {
+public:
+    JsonWriter();
+
+    /// Start over, keeping the allocated buffer
+    void reset();
+
+    const QByteArray& data() const { return m_buffer; }
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    /// Object key. Literal (const char*) keys must be plain ASCII and are
+    /// written without escaping.
+    void key(const char* name);
+    void key(const QString& name);
+
+    void value(const QString& text);
+    void value(const char* utf8);
+    void value(bool flag);
+    void value(int number);
+    void value(qint64 number);
+    void value(double number);
+    void value(const QVariant& variant);
+    void value(const QJsonValue& json);
+    void null();
+
+    /// Append an already encoded JSON value verbatim
+    void raw(const QByteArray& json);
+
+    template<typename T>
+    void field(const char* name, const T& v)
+    {
+        key(name);
+        value(v);
+    }
+
+private:
+    void separator();
+    void writeString(const QString& text);
+
+    QByteArray m_buffer;
+    QVarLengthArray<bool, 8> m_first;  // Per open container: nothing written yet
+    bool m_afterKey;
+};
+
+/**
+ * @brief Write a socket envelope, {"id", "event": {"type", "payload"},
+ * "meta": {"replyTo"?, "ts"}}, into @p w after resetting it.
+ *
+ * @p payload is already encoded JSON; an empty one is sent as {}.
+ * @p replyTo is left out when empty.
+ */
+void writeEnvelope(JsonWriter& w, const QString& eventType, const QByteArray& payload,
+                   const QString& replyTo, const QString& envelopeId, qint64 ts);
+
+#endif // JSONWRITER_H
@@ -1,6 +1,14 @@
 #include "networkclient.h"
 #include <QDebug>
 
+namespace {
+// Requests a host may have in flight before queued work has to wait.
+// Interactive requests ignore these; prefetch and background stop short of
+// the total so there is always headroom for something the user asked for.
+const int kMaxPrefetchPerHost = 4;
+const int kMaxBackgroundPerHost = 2;
+}
+
 NetworkClient::NetworkClient(QObject* parent)
     : QObject(parent)
     , m_networkManager(new QNetworkAccessManager(this))
@@ -9,8 +17,12 @@ NetworkClient::NetworkClient(QObject* parent)
 }
 
 NetworkClient::~NetworkClient() {
+    // Nothing queued may start while replies are torn down
+    m_queue.clear();
+
     // Abort and clean up any pending replies
-    for (QNetworkReply* reply : m_activeReplies) {
+    const QList<QNetworkReply*> replies = m_activeReplies.keys();
+    for (QNetworkReply* reply : replies) {
         reply->abort();
         reply->deleteLater();
     }
@@ -73,15 +85,177 @@ QNetworkReply* NetworkClient::deleteResource(const QUrl& url, const QVariantMap&
 }
 
 void NetworkClient::trackReply(QNetworkReply* reply) {
-    m_activeReplies.insert(reply);
+    QString host = reply->url().host();
+    m_activeReplies.insert(reply, host);
+    m_hostInFlight[host]++;
     connect(reply, &QNetworkReply::finished, this, &NetworkClient::onReplyFinished);
 }
 
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+int NetworkClient::scheduleGet(const QUrl& url, const QVariantMap& headers, Priority priority,
+                               std::function<void(QNetworkReply*)> started,
+                               std::function<void()> dropped) {
+    ScheduledGet job;
+    job.ticket = m_nextTicket++;
+    job.url = url;
+    job.headers = headers;
+    job.priority = priority;
+    job.started = started;
+    job.dropped = dropped;
+
+    // Queue behind anything as urgent already waiting for the host so order is kept
+    bool waiting = false;
+    for (const ScheduledGet& queued : m_queue) {
+        if (queued.priority <= priority && queued.url.host() == url.host()) {
+            waiting = true;
+            break;
+        }
+    }
+
+    if (priority == Priority::Interactive || (!waiting && hasSlot(url.host(), priority))) {
+        QNetworkReply* reply = startGet(job);
+        if (job.started) {
+            job.started(reply);
+        }
+    } else {
+        m_queue.append(job);
+        if (m_debug) {
+            qDebug() << "[NetworkClient] Queued:" << url.toString()
+                     << "Priority:" << static_cast<int>(priority)
+                     << "Waiting:" << m_queue.size();
+        }
+    }
+    return job.ticket;
+}
+
+void NetworkClient::cancelScheduled(int ticket) {
+    for (int i = 0; i < m_queue.size(); ++i) {
+        if (m_queue.at(i).ticket == ticket) {
+            m_queue.removeAt(i);
+            return;
+        }
+    }
+}
+
+bool NetworkClient::promote(int ticket, Priority priority) {
+    for (int i = 0; i < m_queue.size(); ++i) {
+        ScheduledGet& job = m_queue[i];
+        if (job.ticket != ticket) {
+            continue;
+        }
+        if (job.priority <= priority) {
+            return false;
+        }
+        job.priority = priority;
+        job.promoted = true;
+
+        if (priority == Priority::Interactive) {
+            // Interactive requests never wait for a slot
+            ScheduledGet promoted = m_queue.takeAt(i);
+            QNetworkReply* reply = startGet(promoted);
+            if (promoted.started) {
+                promoted.started(reply);
+            }
+        } else {
+            dispatchQueued();
+        }
+        return true;
+    }
+    return false;
+}
+
+int NetworkClient::dropQueued(Priority priority) {
+    // Take them out first; the callbacks may schedule or cancel other work
+    QList<ScheduledGet> dropped;
+    for (int i = 0; i < m_queue.size();) {
+        const ScheduledGet& job = m_queue.at(i);
+        if (job.priority >= priority && !job.promoted) {
+            dropped.append(m_queue.takeAt(i));
+        } else {
+            ++i;
+        }
+    }
+
+    if (m_debug && !dropped.isEmpty()) {
+        qDebug() << "[NetworkClient] Dropped" << dropped.size() << "obsolete queued requests";
+    }
+    for (const ScheduledGet& job : dropped) {
+        if (job.dropped) {
+            job.dropped();
+        }
+    }
+    return dropped.size();
+}
+
+bool NetworkClient::hasSlot(const QString& host, Priority priority) const {
+    int inFlight = m_hostInFlight.value(host);
+    switch (priority) {
+    case Priority::Interactive:
+        return true;
+    case Priority::Prefetch:
+        return inFlight < kMaxPrefetchPerHost;
+    case Priority::Background:
+        return inFlight < kMaxBackgroundPerHost;
+    }
+    return true;
+}
+
+void NetworkClient::dispatchQueued() {
+    // Rescan after every start: the callback may cancel or add queued work
+    forever {
+        int next = -1;
+        for (int i = 0; i < m_queue.size(); ++i) {
+            const ScheduledGet& job = m_queue.at(i);
+            if (hasSlot(job.url.host(), job.priority)
+                    && (next < 0 || job.priority < m_queue.at(next).priority)) {
+                next = i;
+            }
+        }
+        if (next < 0) {
+            return;
+        }
+
+        ScheduledGet job = m_queue.takeAt(next);
+        QNetworkReply* reply = startGet(job);
+        if (job.started) {
+            job.started(reply);
+        }
+    }
+}
+
+QNetworkReply* NetworkClient::startGet(const ScheduledGet& job) {
+    QNetworkRequest request = createRequest(job.url, job.headers);
+
+    // Qt orders its own per-connection queue by this as well
+    switch (job.priority) {
+    case Priority::Interactive:
+        request.setPriority(QNetworkRequest::HighPriority);
+        break;
+    case Priority::Prefetch:
+        request.setPriority(QNetworkRequest::NormalPriority);
+        break;
+    case Priority::Background:
+        request.setPriority(QNetworkRequest::LowPriority);
+        break;
+    }
+
+    logRequest("GET", job.url);
+    QNetworkReply* reply = m_networkManager->get(request);
+    trackReply(reply);
+    return reply;
+}
+
 void NetworkClient::onReplyFinished() {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply) return;
 
-    m_activeReplies.remove(reply);
+    QString host = m_activeReplies.take(reply);
+    if (--m_hostInFlight[host] <= 0) {
+        m_hostInFlight.remove(host);
+    }
 
     int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
 
@@ -98,6 +272,11 @@ void NetworkClient::onReplyFinished() {
         qDebug() << "[NetworkClient] 401 Unauthorized detected - token may be expired";
         emit authTokenExpired();
     }
+
+    // A slot on this host is free again
+    if (!m_queue.isEmpty()) {
+        dispatchQueued();
+    }
     // Note: Caller is responsible for reading data and deleting the reply
 }
 
@@ -122,6 +301,13 @@ QNetworkRequest NetworkClient::createRequest(const QUrl& url, const QVariantMap&
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     request.setHeader(QNetworkRequest::UserAgentHeader, "Serchat/1.0");
 
+    // Multiplex over one connection when the server speaks HTTP/2
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+#elif QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    request.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+#endif
+
     // Add Authorization header if token is available
     if (!m_authToken.isEmpty()) {
         request.setRawHeader("Authorization", QStringLiteral("Bearer %1").arg(m_authToken).toUtf8());
@@ -7,7 +7,9 @@
 #include <QNetworkRequest>
 #include <QUrl>
 #include <QVariantMap>
-#include <QSet>
+#include <QHash>
+#include <QList>
+#include <functional>
 
 /**
  * @brief Low-level HTTP client with automatic auth header injection.
@@ -16,11 +18,22 @@
  * - Automatic Bearer token injection
  * - Debug logging (non-destructive)
  * - 401 detection for token expiration
+ * - Prioritized GETs: interactive requests go out at once; prefetch and
+ *   background requests wait for a free per-host slot, can be dropped when
+ *   obsolete, and are marked lower priority for Qt's own queue. HTTP/2 is
+ *   allowed where the server offers it.
  */
 class NetworkClient : public QObject {
     Q_OBJECT
 
 public:
+    /// Scheduling classes for scheduleGet(), most urgent first
+    enum class Priority {
+        Interactive,   // What the user just asked for
+        Prefetch,      // Likely needed soon (lists for the visible server)
+        Background     // Nice to have (profiles, emojis, metadata)
+    };
+
     explicit NetworkClient(QObject* parent = nullptr);
     ~NetworkClient();
 
@@ -41,6 +54,38 @@ public:
     QNetworkReply* patch(const QUrl& url, const QByteArray& data, const QVariantMap& headers = {});
     QNetworkReply* deleteResource(const QUrl& url, const QVariantMap& headers = {});
 
+    /**
+     * @brief Schedule a GET by priority.
+     * 
+     * Interactive requests are dispatched immediately. Prefetch and
+     * background ones wait until their host has fewer requests in flight
+     * than the class allows. `started` receives the reply once dispatched
+     * (possibly before this returns); `dropped` runs instead if the request
+     * is discarded by dropQueued().
+     * 
+     * @return Ticket for cancelScheduled()
+     */
+    int scheduleGet(const QUrl& url, const QVariantMap& headers, Priority priority,
+                    std::function<void(QNetworkReply*)> started,
+                    std::function<void()> dropped = nullptr);
+
+    /// Forget a scheduled GET that hasn't been dispatched yet (no callbacks)
+    void cancelScheduled(int ticket);
+
+    /**
+     * @brief Make a queued GET more urgent, e.g. when the user asks for
+     * something a prefetch is already waiting for.
+     * 
+     * Promoted to Interactive it starts right away. Promoted GETs are no
+     * longer discarded by dropQueued(). Returns false if the ticket isn't
+     * queued or already at least as urgent.
+     */
+    bool promote(int ticket, Priority priority);
+
+    /// Drop every queued GET of `priority` or lower as obsolete, except
+    /// promoted ones. Returns the count.
+    int dropQueued(Priority priority);
+
 signals:
     /// Emitted when any request receives a 401 Unauthorized response
     void authTokenExpired();
@@ -49,13 +94,35 @@ private slots:
     void onReplyFinished();
 
 private:
+    struct ScheduledGet {
+        int ticket = 0;
+        QUrl url;
+        QVariantMap headers;
+        Priority priority = Priority::Interactive;
+        bool promoted = false;  // Raised by promote(); kept by dropQueued()
+        std::function<void(QNetworkReply*)> started;
+        std::function<void()> dropped;
+    };
+
     QNetworkAccessManager* m_networkManager;
     QString m_authToken;
     bool m_debug = false;
-    QSet<QNetworkReply*> m_activeReplies;
+    QHash<QNetworkReply*, QString> m_activeReplies;  // reply -> host
+
+    // Scheduler
+    QList<ScheduledGet> m_queue;         // Waiting GETs, oldest first
+    QHash<QString, int> m_hostInFlight;  // host -> replies not finished yet
+    int m_nextTicket = 1;
 
     QNetworkRequest createRequest(const QUrl& url, const QVariantMap& headers = {});
     void trackReply(QNetworkReply* reply);
+    
+    /// Whether a request of this class may start on the host now
+    bool hasSlot(const QString& host, Priority priority) const;
+    
+    /// Start queued GETs that have a slot, most urgent first
+    void dispatchQueued();
+    QNetworkReply* startGet(const ScheduledGet& job);
     void logRequest(const QString& method, const QUrl& url, const QByteArray& data = {});
 };
 
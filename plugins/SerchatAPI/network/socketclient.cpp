@@ -1,10 +1,53 @@
 #include "socketclient.h"
+#include "socketdecoder.h"
 #include <QDebug>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QUrlQuery>
 #include <QDateTime>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <algorithm>
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+#include <QNetworkConfigurationManager>
+#endif
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+#include <QCborValue>
+#include <QCborMap>
+#endif
+
+namespace {
+// Upper bounds of the handler timing histogram buckets (last bucket is open)
+const qint64 kTimingBucketBoundsUs[SocketClient::kTimingBuckets - 1] = {
+    10, 50, 100, 500, 1000, 5000, 16000
+};
+
+// Don't ask to resume sessions that dropped longer ago than this; the server would most
+// likely refuse and a full resync is cheaper than a huge replay anyway
+const qint64 kMaxResumeGapMs = 10 * 60 * 1000;
+
+// Reconnect backoff: 1s doubling up to 30s, then (keep-trying mode) a
+// steady slow retry. Every delay is jittered.
+const int kReconnectBaseMs = 1000;
+const int kReconnectMaxMs = 30000;
+const int kKeepTryingMs = 60000;
+
+// Heartbeat: starts at 25s and stretches on a stable link; the pong
+// timeout follows the measured round trip. The cap stays well under the
+// 60s idle timeout common to proxies and carrier NATs.
+const int kBasePingIntervalMs = 25000;
+const int kMaxPingIntervalMs = 45000;
+const int kMinPongTimeoutMs = 3000;
+const int kMaxPongTimeoutMs = 10000;
+
+// Outbound queue
+const int kMaxOutbox = 100;          // Oldest events are dropped beyond this
+const int kAckTimeoutMs = 10000;     // Resend if the server hasn't acked by then
+const int kMaxSendAttempts = 3;
+const int kTypingMaxAgeMs = 5000;    // Older typing pings are meaningless
+}
 
 SocketClient::SocketClient(QObject *parent)
     : QObject(parent)
@@ -13,12 +56,29 @@ SocketClient::SocketClient(QObject *parent)
     , m_authenticated(false)
     , m_pingTimer(new QTimer(this))
     , m_pongTimeoutTimer(new QTimer(this))
-    , m_pingInterval(25000)   // Send ping every 25 seconds
-    , m_pingTimeout(10000)    // Wait 10 seconds for pong
+    , m_pingInterval(kBasePingIntervalMs)
+    , m_pingTimeout(kMaxPongTimeoutMs)
+    , m_lastInboundAt(0)
+    , m_pingSentAt(0)
+    , m_controlPongSeen(false)
     , m_reconnectTimer(new QTimer(this))
     , m_reconnectAttempts(0)
     , m_maxReconnectAttempts(10)
     , m_shouldReconnect(true)
+    , m_keepTrying(true)
+    , m_networkOnline(true)
+    , m_decoderThread(new QThread(this))
+    , m_decoder(new SocketDecoder)
+    , m_generation(0)
+    , m_binaryTransport(false)
+    , m_peerUsesCbor(false)
+    , m_batchTimer(new QTimer(this))
+    , m_batchWindow(-1)
+    , m_lastEventSeq(0)
+    , m_disconnectedAt(0)
+    , m_sessionResumed(false)
+    , m_ackTimer(new QTimer(this))
+    , m_idCounter(0)
 {
     QObject::connect(m_socket, &QWebSocket::connected, 
                      this, &SocketClient::onWebSocketConnected);
@@ -28,6 +88,10 @@ SocketClient::SocketClient(QObject *parent)
                      this, &SocketClient::onWebSocketError);
     QObject::connect(m_socket, &QWebSocket::textMessageReceived,
                      this, &SocketClient::onTextMessageReceived);
+    QObject::connect(m_socket, &QWebSocket::binaryMessageReceived,
+                     this, &SocketClient::onBinaryMessageReceived);
+    QObject::connect(m_socket, &QWebSocket::pong,
+                     this, &SocketClient::onControlPong);
     
     // Ping timer - send heartbeat to keep connection alive
     QObject::connect(m_pingTimer, &QTimer::timeout, 
@@ -38,20 +102,61 @@ SocketClient::SocketClient(QObject *parent)
     QObject::connect(m_reconnectTimer, &QTimer::timeout,
                      this, &SocketClient::onReconnectTimeout);
     
-    m_pingTimer->setSingleShot(false);
+    m_pingTimer->setSingleShot(true);
     m_pongTimeoutTimer->setSingleShot(true);
     m_reconnectTimer->setSingleShot(true);
+    
+    // Envelope IDs issued before the first connect (queued while offline)
+    m_idPrefix = newIdPrefix();
+    
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+    // Reconnect as soon as the network comes back instead of waiting out
+    // the backoff. Only state changes are trusted, and even those only as a
+    // hint; without a bearer plugin isOnline() can be wrong. The bearer API
+    // is deprecated from Qt 5.15 on, where the backoff alone applies.
+    m_networkConfig = new QNetworkConfigurationManager(this);
+    QObject::connect(m_networkConfig, &QNetworkConfigurationManager::onlineStateChanged,
+                     this, &SocketClient::onNetworkOnlineChanged);
+#endif
+    
+    m_ackTimer->setSingleShot(true);
+    QObject::connect(m_ackTimer, &QTimer::timeout,
+                     this, &SocketClient::onAckTimeout);
+    
+    m_batchTimer->setSingleShot(true);
+    QObject::connect(m_batchTimer, &QTimer::timeout,
+                     this, &SocketClient::dispatchReadyEvents);
+    
+    // Frames are decoded off the GUI thread; only dispatch happens here
+    m_decoder->moveToThread(m_decoderThread);
+    QObject::connect(m_decoderThread, &QThread::finished,
+                     m_decoder, &QObject::deleteLater);
+    QObject::connect(m_decoder, &SocketDecoder::eventsReady,
+                     this, &SocketClient::onEventsReady);
+    m_decoderThread->setObjectName("SocketDecoder");
+    m_decoderThread->start();
 }
 
 SocketClient::~SocketClient()
 {
     m_shouldReconnect = false;
     disconnect();
+    
+    m_decoderThread->quit();
+    m_decoderThread->wait();
+}
+
+QString SocketClient::newIdPrefix()
+{
+    // 64 random bits keep prefixes apart across connections and clients
+    return QString::number(QRandomGenerator::global()->generate64(), 36) + QLatin1Char('-');
 }
 
 QString SocketClient::generateMessageId()
 {
-    return QUuid::createUuid().toString(QUuid::WithoutBraces);
+    // Unique for replyTo correlation without touching the system RNG per
+    // envelope: typing indicators and pings go out far too often for that
+    return m_idPrefix + QString::number(++m_idCounter, 36);
 }
 
 void SocketClient::connect(const QString& url, const QString& authToken)
@@ -60,14 +165,31 @@ void SocketClient::connect(const QString& url, const QString& authToken)
         disconnect();
     }
     
+    // A different account can't resume this session
+    if (authToken != m_authToken) {
+        resetSession();
+    }
+    
     m_url = url;
     m_authToken = authToken;
     m_reconnectAttempts = 0;
     m_shouldReconnect = true;
+    m_reconnectTimer->stop();
+    
+    openSocket();
+}
+
+void SocketClient::openSocket()
+{
+    m_sessionResumed = false;
+    m_generation++;
+    m_idPrefix = newIdPrefix();
+    m_idCounter = 0;
+    m_peerUsesCbor = false;
     m_authenticated = false;
     
     // Build WebSocket URL
-    QUrl wsUrl(url);
+    QUrl wsUrl(m_url);
     if (wsUrl.scheme() == "https") {
         wsUrl.setScheme("wss");
     } else if (wsUrl.scheme() == "http") {
@@ -87,6 +209,15 @@ void SocketClient::connect(const QString& url, const QString& authToken)
     }
     wsUrl.setPath(path);
     
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    if (m_binaryTransport) {
+        QUrlQuery query(wsUrl);
+        query.removeQueryItem("encoding");
+        query.addQueryItem("encoding", "cbor");
+        wsUrl.setQuery(query);
+    }
+#endif
+    
     qDebug() << "[SocketClient] Connecting to:" << wsUrl.toString();
     
     m_socket->open(wsUrl);
@@ -98,13 +229,30 @@ void SocketClient::disconnect()
     m_pingTimer->stop();
     m_pongTimeoutTimer->stop();
     m_reconnectTimer->stop();
+    m_ackTimer->stop();
     m_pendingReplies.clear();
+    
+    // Explicit disconnect (logout): nothing queued should go out later
+    m_outbox.clear();
+    
+    // Drop anything still being decoded for this connection
+    m_generation++;
 
+    if (m_authenticated) {
+        m_disconnectedAt = QDateTime::currentMSecsSinceEpoch();
+    }
     m_socket->close();
     m_connected = false;
     m_authenticated = false;
 }
 
+void SocketClient::resetSession()
+{
+    m_lastEventSeq = 0;
+    m_disconnectedAt = 0;
+    m_sessionResumed = false;
+}
+
 void SocketClient::resetReconnectAttempts()
 {
     m_reconnectAttempts = 0;
@@ -113,223 +261,525 @@ void SocketClient::resetReconnectAttempts()
     qDebug() << "[SocketClient] Reconnect attempts reset";
 }
 
+void SocketClient::setKeepTrying(bool keepTrying)
+{
+    m_keepTrying = keepTrying;
+}
+
+bool SocketClient::reconnectNow()
+{
+    if (!m_shouldReconnect || m_url.isEmpty() || m_connected) {
+        return false;
+    }
+    if (m_socket->state() == QAbstractSocket::ConnectingState
+            || m_socket->state() == QAbstractSocket::HostLookupState) {
+        return true;  // Already on its way
+    }
+    
+    // The caller knows better than an offline hint that may be stale
+    
+    qDebug() << "[SocketClient] Reconnecting now";
+    m_reconnectTimer->stop();
+    m_reconnectAttempts = 0;
+    emit reconnecting(1);
+    openSocket();
+    return true;
+}
+
 void SocketClient::checkConnectionHealth()
 {
+    // Waiting out a backoff delay - the caller knows now is a good moment
+    if (m_reconnectTimer->isActive()) {
+        reconnectNow();
+        return;
+    }
+    
     if (!m_connected || !m_authenticated) {
         qDebug() << "[SocketClient] Not connected/authenticated, skipping health check";
         return;
     }
+    
+    // A ping is already out; its pong timeout decides
+    if (m_pongTimeoutTimer->isActive()) {
+        return;
+    }
 
     qDebug() << "[SocketClient] Checking connection health";
     sendPing();
 }
 
+void SocketClient::onNetworkOnlineChanged(bool online)
+{
+    if (online == m_networkOnline) {
+        return;
+    }
+    m_networkOnline = online;
+    qDebug() << "[SocketClient] Network" << (online ? "online" : "offline");
+    
+    if (!online) {
+        // scheduleReconnect() slows down from here on
+        return;
+    }
+    
+    // Switching networks usually leaves a half-dead connection behind
+    if (m_connected) {
+        checkConnectionHealth();
+    } else {
+        reconnectNow();
+    }
+}
+
 // ============================================================================
 // Event emission
 // ============================================================================
 
-void SocketClient::sendEnvelope(const QString& eventType, const QVariantMap& payload,
-                                 const QString& replyTo)
+void SocketClient::sendEnvelope(const QString& eventType, const QByteArray& payload,
+                                 const QString& replyTo, const QString& envelopeId)
 {
     if (!m_connected) {
         qWarning() << "[SocketClient] Cannot send event, not connected:" << eventType;
         return;
     }
     
-    QJsonObject envelope;
-    envelope["id"] = generateMessageId();
-    
-    QJsonObject event;
-    event["type"] = eventType;
-    event["payload"] = QJsonObject::fromVariantMap(payload);
-    envelope["event"] = event;
+    qDebug() << "[SocketClient] Sending:" << eventType;
     
-    QJsonObject meta;
-    if (!replyTo.isEmpty()) {
-        meta["replyTo"] = replyTo;
+    QString id = envelopeId.isEmpty() ? generateMessageId() : envelopeId;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    if (m_peerUsesCbor) {
+        m_socket->sendBinaryMessage(encodeEnvelope(eventType, payload, replyTo, id, true));
+        return;
     }
-    meta["ts"] = QDateTime::currentMSecsSinceEpoch();
-    envelope["meta"] = meta;
+#endif
+    
+    // QWebSocket only takes text frames as QString, so this is the one
+    // conversion left; it re-encodes to UTF-8 while framing
+    m_socket->sendTextMessage(QString::fromUtf8(encodeEnvelope(eventType, payload, replyTo, id, false)));
+}
+
+QByteArray SocketClient::encodeEnvelope(const QString& eventType, const QByteArray& payload,
+                                        const QString& replyTo, const QString& envelopeId,
+                                        bool binary)
+{
+    qint64 ts = QDateTime::currentMSecsSinceEpoch();
     
-    QJsonDocument doc(envelope);
-    QString message = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    if (binary) {
+        // CBOR peers are opt-in; they keep the tree path
+        QCborMap event;
+        event[QLatin1String("type")] = eventType;
+        event[QLatin1String("payload")] = QCborValue::fromJsonValue(
+                    QJsonDocument::fromJson(payload).object());
+        QCborMap meta;
+        if (!replyTo.isEmpty()) {
+            meta[QLatin1String("replyTo")] = replyTo;
+        }
+        meta[QLatin1String("ts")] = ts;
+        QCborMap envelope;
+        envelope[QLatin1String("id")] = envelopeId;
+        envelope[QLatin1String("event")] = event;
+        envelope[QLatin1String("meta")] = meta;
+        return envelope.toCborValue().toCbor();
+    }
+#else
+    Q_UNUSED(binary)
+#endif
     
-    qDebug() << "[SocketClient] Sending:" << eventType;
-    m_socket->sendTextMessage(message);
+    // Written straight into the reused frame buffer; the payload is
+    // already encoded
+    writeEnvelope(m_frameWriter, eventType, payload, replyTo, envelopeId, ts);
+    return m_frameWriter.data();
+}
+
+QVariantMap SocketClient::decodePayload(const QByteArray& payload)
+{
+    return QJsonDocument::fromJson(payload).object().toVariantMap();
 }
 
 void SocketClient::emitEvent(const QString& eventType, const QVariantMap& payload)
 {
-    sendEnvelope(eventType, payload);
+    JsonWriter writer;
+    writer.value(QVariant(payload));
+    queueEvent(eventType, writer.data());
+}
+
+// ============================================================================
+// Outbound queue
+// ============================================================================
+
+void SocketClient::queueEvent(const QString& eventType, const QByteArray& payload,
+                              const QString& coalesceKey, int maxAgeMs)
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    
+    // Only the latest of a coalesced kind matters; replace it unless it's
+    // already on the wire
+    if (!coalesceKey.isEmpty()) {
+        for (int i = 0; i < m_outbox.size(); ++i) {
+            if (m_outbox.at(i).coalesceKey == coalesceKey && m_outbox.at(i).sentAt == 0) {
+                m_outbox.removeAt(i);
+                break;
+            }
+        }
+    }
+    
+    OutboundEvent event;
+    event.id = generateMessageId();
+    event.type = eventType;
+    event.payload = payload;
+    event.coalesceKey = coalesceKey;
+    event.expiresAt = maxAgeMs > 0 ? now + maxAgeMs : 0;
+    m_outbox.append(event);
+    
+    while (m_outbox.size() > kMaxOutbox) {
+        OutboundEvent dropped = m_outbox.takeFirst();
+        qWarning() << "[SocketClient] Outbound queue full, dropping:" << dropped.type;
+        emit sendFailed(dropped.type, decodePayload(dropped.payload));
+    }
+    
+    if (isConnected()) {
+        flushOutbox();
+    } else {
+        qDebug() << "[SocketClient] Queued while offline:" << eventType
+                 << "(" << m_outbox.size() << "pending)";
+    }
+}
+
+void SocketClient::flushOutbox()
+{
+    if (!isConnected()) {
+        return;
+    }
+    
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    int i = 0;
+    while (i < m_outbox.size()) {
+        OutboundEvent& event = m_outbox[i];
+        if (event.sentAt != 0) {
+            ++i;  // Waiting for its ack
+            continue;
+        }
+        if (event.expiresAt != 0 && now > event.expiresAt) {
+            m_outbox.removeAt(i);
+            continue;
+        }
+        
+        // Same envelope ID on every attempt so the server can drop repeats.
+        // Kept until acked, or for types the server doesn't ack, until a pong
+        // shows the connection was alive after the write.
+        sendEnvelope(event.type, event.payload, QString(), event.id);
+        event.attempts++;
+        event.sentAt = now;
+        ++i;
+    }
+    
+    if (!m_outbox.isEmpty() && !m_ackTimer->isActive()) {
+        m_ackTimer->start(kAckTimeoutMs);
+    }
+}
+
+bool SocketClient::acknowledge(const QString& envelopeId)
+{
+    for (int i = 0; i < m_outbox.size(); ++i) {
+        if (m_outbox.at(i).id == envelopeId) {
+            // From now on this type waits for its ack rather than a pong
+            m_ackedTypes.insert(m_outbox.at(i).type);
+            m_outbox.removeAt(i);
+            if (m_outbox.isEmpty()) {
+                m_ackTimer->stop();
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void SocketClient::confirmWrittenBefore(qint64 pingSentAt)
+{
+    // The server answered a ping sent after these were written, so it has
+    // read them; nothing more will come back for these types
+    for (int i = m_outbox.size() - 1; i >= 0; --i) {
+        const OutboundEvent& event = m_outbox.at(i);
+        if (event.sentAt != 0 && event.sentAt < pingSentAt && !m_ackedTypes.contains(event.type)) {
+            m_outbox.removeAt(i);
+        }
+    }
+    if (m_outbox.isEmpty()) {
+        m_ackTimer->stop();
+    }
+}
+
+void SocketClient::onAckTimeout()
+{
+    if (!isConnected()) {
+        return;  // Resent after the next 'authenticated'
+    }
+    
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    bool needsProbe = false;
+    for (int i = m_outbox.size() - 1; i >= 0; --i) {
+        OutboundEvent& event = m_outbox[i];
+        if (event.sentAt == 0 || now - event.sentAt < kAckTimeoutMs) {
+            continue;
+        }
+        if (!m_ackedTypes.contains(event.type)) {
+            // No ack is coming; a pong settles it, a pong timeout resends it
+            needsProbe = true;
+            continue;
+        }
+        if (event.attempts >= kMaxSendAttempts) {
+            qWarning() << "[SocketClient] No ack after" << event.attempts << "attempts:" << event.type;
+            OutboundEvent dropped = m_outbox.takeAt(i);
+            emit sendFailed(dropped.type, decodePayload(dropped.payload));
+            continue;
+        }
+        event.sentAt = 0;  // Due for a resend
+    }
+    
+    if (needsProbe && m_pingSentAt == 0) {
+        sendPing();
+    }
+    flushOutbox();
 }
 
 void SocketClient::sendAuthentication()
 {
-    QVariantMap payload;
-    payload["token"] = m_authToken;
-    sendEnvelope("authenticate", payload);
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("token", m_authToken);
+    
+    // Offer to resume where we left off so the server can replay the gap
+    if (m_lastEventSeq > 0 && m_disconnectedAt > 0
+            && QDateTime::currentMSecsSinceEpoch() - m_disconnectedAt < kMaxResumeGapMs) {
+        payload.field("lastEventSeq", m_lastEventSeq);
+        qDebug() << "[SocketClient] Requesting session resume from seq" << m_lastEventSeq;
+    }
+    payload.endObject();
+    sendEnvelope("authenticate", payload.data());
 }
 
 void SocketClient::sendPing()
 {
-    sendEnvelope("ping", {});
+    m_pingSentAt = QDateTime::currentMSecsSinceEpoch();
+    
+    // A control frame is answered by the WebSocket layer itself and costs
+    // a few bytes. Until one has come back on this connection, also send
+    // the protocol-level ping in case something in between eats them.
+    m_socket->ping();
+    if (!m_controlPongSeen) {
+        sendEnvelope("ping", QByteArray());
+    }
     m_pongTimeoutTimer->start(m_pingTimeout);
 }
 
+void SocketClient::handlePong(qint64 roundTripMs)
+{
+    if (m_pingSentAt == 0) {
+        return;  // Late duplicate (control and protocol pong for one ping)
+    }
+    qint64 pingSentAt = m_pingSentAt;
+    m_pingSentAt = 0;
+    m_pongTimeoutTimer->stop();
+    confirmWrittenBefore(pingSentAt);
+    
+    // Dead links are noticed sooner on fast connections
+    m_pingTimeout = static_cast<int>(qBound<qint64>(kMinPongTimeoutMs, roundTripMs * 4 + 1000, kMaxPongTimeoutMs));
+    
+    // Each clean round trip earns a longer quiet period
+    m_pingInterval = qMin(m_pingInterval * 3 / 2, kMaxPingIntervalMs);
+    
+    qDebug() << "[SocketClient] Pong in" << roundTripMs << "ms, next ping in"
+             << m_pingInterval << "ms";
+}
+
 // ============================================================================
 // High-level API methods
 // ============================================================================
 
 void SocketClient::joinServer(const QString& serverId)
 {
-    QVariantMap payload;
-    payload["serverId"] = serverId;
-    emitEvent("join_server", payload);
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("serverId", serverId);
+    payload.endObject();
+    queueEvent("join_server", payload.data());
 }
 
 void SocketClient::joinChannel(const QString& serverId, const QString& channelId)
 {
-    QVariantMap payload;
-    payload["serverId"] = serverId;
-    payload["channelId"] = channelId;
-    emitEvent("join_channel", payload);
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("serverId", serverId);
+    payload.field("channelId", channelId);
+    payload.endObject();
+    queueEvent("join_channel", payload.data());
 }
 
 void SocketClient::leaveServer(const QString& serverId)
 {
-    QVariantMap payload;
-    payload["serverId"] = serverId;
-    emitEvent("leave_server", payload);
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("serverId", serverId);
+    payload.endObject();
+    queueEvent("leave_server", payload.data());
 }
 
 void SocketClient::leaveChannel(const QString& channelId)
 {
-    QVariantMap payload;
-    payload["channelId"] = channelId;
-    emitEvent("leave_channel", payload);
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("channelId", channelId);
+    payload.endObject();
+    queueEvent("leave_channel", payload.data());
 }
 
 void SocketClient::markChannelRead(const QString& serverId, const QString& channelId)
 {
-    QVariantMap payload;
-    payload["serverId"] = serverId;
-    payload["channelId"] = channelId;
-    emitEvent("mark_channel_read", payload);
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("serverId", serverId);
+    payload.field("channelId", channelId);
+    payload.endObject();
+    queueEvent("mark_channel_read", payload.data(), "mark_channel_read:" + serverId + ":" + channelId);
 }
 
 void SocketClient::markDMRead(const QString& peerId)
 {
-    QVariantMap payload;
-    payload["peerId"] = peerId;
-    emitEvent("mark_dm_read", payload);
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("peerId", peerId);
+    payload.endObject();
+    queueEvent("mark_dm_read", payload.data(), "mark_dm_read:" + peerId);
 }
 
 void SocketClient::sendTyping(const QString& serverId, const QString& channelId)
 {
-    QVariantMap payload;
-    payload["serverId"] = serverId;
-    payload["channelId"] = channelId;
-    emitEvent("typing_server", payload);
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("serverId", serverId);
+    payload.field("channelId", channelId);
+    payload.endObject();
+    queueEvent("typing_server", payload.data(), "typing_server:" + serverId + ":" + channelId,
+               kTypingMaxAgeMs);
 }
 
 void SocketClient::sendDMTyping(const QString& receiverId)
 {
-    QVariantMap payload;
-    payload["receiverId"] = receiverId;
-    emitEvent("typing_dm", payload);
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("receiverId", receiverId);
+    payload.endObject();
+    queueEvent("typing_dm", payload.data(), "typing_dm:" + receiverId, kTypingMaxAgeMs);
 }
 
 void SocketClient::sendServerMessage(const QString& serverId, const QString& channelId, 
                                       const QString& text, const QString& replyToId)
 {
-    QVariantMap payload;
-    payload["serverId"] = serverId;
-    payload["channelId"] = channelId;
-    payload["text"] = text;
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("serverId", serverId);
+    payload.field("channelId", channelId);
+    payload.field("text", text);
     if (!replyToId.isEmpty()) {
-        payload["replyToId"] = replyToId;
+        payload.field("replyToId", replyToId);
     }
-    emitEvent("send_message_server", payload);
+    payload.endObject();
+    queueEvent("send_message_server", payload.data());
 }
 
 void SocketClient::sendDirectMessage(const QString& receiverId, const QString& text, 
                                       const QString& replyToId)
 {
-    QVariantMap payload;
-    payload["receiverId"] = receiverId;
-    payload["text"] = text;
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("receiverId", receiverId);
+    payload.field("text", text);
     if (!replyToId.isEmpty()) {
-        payload["replyToId"] = replyToId;
+        payload.field("replyToId", replyToId);
     }
-    emitEvent("send_message_dm", payload);
+    payload.endObject();
+    queueEvent("send_message_dm", payload.data());
 }
 
 void SocketClient::editServerMessage(const QString& messageId, const QString& text)
 {
-    QVariantMap payload;
-    payload["messageId"] = messageId;
-    payload["text"] = text;
-    emitEvent("edit_message_server", payload);
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("messageId", messageId);
+    payload.field("text", text);
+    payload.endObject();
+    queueEvent("edit_message_server", payload.data());
 }
 
 void SocketClient::deleteServerMessage(const QString& serverId, const QString& messageId)
 {
-    QVariantMap payload;
-    payload["serverId"] = serverId;
-    payload["messageId"] = messageId;
-    emitEvent("delete_message_server", payload);
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("serverId", serverId);
+    payload.field("messageId", messageId);
+    payload.endObject();
+    queueEvent("delete_message_server", payload.data());
 }
 
 void SocketClient::editDirectMessage(const QString& messageId, const QString& text)
 {
-    QVariantMap payload;
-    payload["messageId"] = messageId;
-    payload["text"] = text;
-    emitEvent("edit_message_dm", payload);
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("messageId", messageId);
+    payload.field("text", text);
+    payload.endObject();
+    queueEvent("edit_message_dm", payload.data());
 }
 
 void SocketClient::deleteDirectMessage(const QString& messageId)
 {
-    QVariantMap payload;
-    payload["messageId"] = messageId;
-    emitEvent("delete_message_dm", payload);
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("messageId", messageId);
+    payload.endObject();
+    queueEvent("delete_message_dm", payload.data());
 }
 
 void SocketClient::addReaction(const QString& messageId, const QString& messageType,
                                const QString& emoji, const QString& emojiType,
                                const QString& emojiId)
 {
-    QVariantMap payload;
-    payload["messageId"] = messageId;
-    payload["emoji"] = emoji;
-    payload["emojiType"] = emojiType;
-    payload["messageType"] = messageType;
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("messageId", messageId);
+    payload.field("emoji", emoji);
+    payload.field("emojiType", emojiType);
+    payload.field("messageType", messageType);
     if (!emojiId.isEmpty()) {
-        payload["emojiId"] = emojiId;
+        payload.field("emojiId", emojiId);
     }
-    emitEvent("add_reaction", payload);
+    payload.endObject();
+    queueEvent("add_reaction", payload.data());
 }
 
 void SocketClient::removeReaction(const QString& messageId, const QString& messageType,
                                    const QString& emoji, const QString& emojiType,
                                    const QString& emojiId)
 {
-    QVariantMap payload;
-    payload["messageId"] = messageId;
-    payload["emoji"] = emoji;
-    payload["emojiType"] = emojiType;
-    payload["messageType"] = messageType;
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("messageId", messageId);
+    payload.field("emoji", emoji);
+    payload.field("emojiType", emojiType);
+    payload.field("messageType", messageType);
     if (!emojiId.isEmpty()) {
-        payload["emojiId"] = emojiId;
+        payload.field("emojiId", emojiId);
     }
-    emitEvent("remove_reaction", payload);
+    payload.endObject();
+    queueEvent("remove_reaction", payload.data());
 }
 
 void SocketClient::setStatus(const QString& status)
 {
-    QVariantMap payload;
-    payload["status"] = status;
-    emitEvent("set_status", payload);
+    JsonWriter payload;
+    payload.beginObject();
+    payload.field("status", status);
+    payload.endObject();
+    queueEvent("set_status", payload.data(), "set_status");
 }
 
 // ============================================================================
@@ -340,7 +790,6 @@ void SocketClient::onWebSocketConnected()
 {
     qDebug() << "[SocketClient] WebSocket connected";
     m_connected = true;
-    m_reconnectAttempts = 0;
     
     // Send authentication immediately (within 30s grace period)
     if (!m_authToken.isEmpty()) {
@@ -354,12 +803,22 @@ void SocketClient::onWebSocketDisconnected()
 {
     qDebug() << "[SocketClient] WebSocket disconnected";
     bool wasConnected = m_connected && m_authenticated;
+    if (wasConnected) {
+        // The resume window counts from here; failed reconnects don't move it
+        m_disconnectedAt = QDateTime::currentMSecsSinceEpoch();
+    }
     m_connected = false;
     m_authenticated = false;
     m_pingTimer->stop();
     m_pongTimeoutTimer->stop();
+    m_ackTimer->stop();
     m_pendingReplies.clear();
     
+    // Whatever wasn't acked goes out again after re-authenticating
+    for (OutboundEvent& event : m_outbox) {
+        event.sentAt = 0;
+    }
+    
     emit connectedChanged();
     if (wasConnected) {
         emit disconnected();
@@ -376,42 +835,134 @@ void SocketClient::onWebSocketError(QAbstractSocket::SocketError err)
     emit error(m_socket->errorString());
 }
 
+void SocketClient::setBinaryTransport(bool enabled)
+{
+    m_binaryTransport = enabled;
+}
+
+void SocketClient::noteInboundTraffic()
+{
+    // Any frame proves the link; onPingTimeout() skips the ping while
+    // traffic keeps flowing (cheaper than restarting a timer per frame)
+    m_lastInboundAt = QDateTime::currentMSecsSinceEpoch();
+    m_pongTimeoutTimer->stop();
+}
+
+void SocketClient::onControlPong(quint64 elapsedTime, const QByteArray& payload)
+{
+    Q_UNUSED(payload)
+    m_lastInboundAt = QDateTime::currentMSecsSinceEpoch();
+    m_controlPongSeen = true;
+    handlePong(static_cast<qint64>(elapsedTime));
+}
+
 void SocketClient::onTextMessageReceived(const QString& message)
 {
     if (message.isEmpty()) return;
     
-    // Reset ping timer on any message received
-    if (m_pingTimer->isActive()) {
-        m_pingTimer->start(m_pingInterval);
+    noteInboundTraffic();
+    
+    // Parsing happens on the decoder thread; results come back through
+    // onEventsReady() in arrival order
+    SocketDecoder* decoder = m_decoder;
+    quint64 generation = m_generation;
+    QMetaObject::invokeMethod(decoder, [decoder, generation, message]() {
+        decoder->decode(generation, message);
+    }, Qt::QueuedConnection);
+}
+
+void SocketClient::setBatchWindow(int msecs)
+{
+    m_batchWindow = msecs;
+    if (m_batchWindow < 0 && m_batchTimer->isActive()) {
+        m_batchTimer->stop();
+        dispatchReadyEvents();
     }
-    m_pongTimeoutTimer->stop();
+}
+
+void SocketClient::onBinaryMessageReceived(const QByteArray& message)
+{
+    if (message.isEmpty()) return;
     
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8(), &parseError);
+    noteInboundTraffic();
     
-    if (parseError.error != QJsonParseError::NoError) {
-        qWarning() << "[SocketClient] JSON parse error:" << parseError.errorString();
+    // A binary frame means the server accepted CBOR; answer in kind
+    if (m_binaryTransport && !m_peerUsesCbor) {
+        qDebug() << "[SocketClient] Server speaks CBOR, switching encoding";
+        m_peerUsesCbor = true;
+    }
+    
+    SocketDecoder* decoder = m_decoder;
+    quint64 generation = m_generation;
+    QMetaObject::invokeMethod(decoder, [decoder, generation, message]() {
+        decoder->decodeBinary(generation, message);
+    }, Qt::QueuedConnection);
+}
+
+void SocketClient::onEventsReady()
+{
+    if (m_batchWindow < 0) {
+        dispatchReadyEvents();
         return;
     }
     
-    if (!doc.isObject()) {
-        qWarning() << "[SocketClient] Expected JSON object envelope";
+    // Let the decoder keep queueing until the window closes; it won't
+    // signal again until the queue has been drained
+    if (!m_batchTimer->isActive()) {
+        m_batchTimer->start(m_batchWindow);
+    }
+}
+
+void SocketClient::dispatchReadyEvents()
+{
+    QQueue<SocketEvent> events = m_decoder->takeReady();
+    if (events.isEmpty()) {
         return;
     }
     
-    handleEnvelope(doc.object());
+    bool batched = m_batchWindow >= 0;
+    if (batched) {
+        emit batchStarted();
+    }
+    
+    while (!events.isEmpty()) {
+        SocketEvent event = events.dequeue();
+        
+        // A handler may have disconnected or reconnected mid-batch
+        if (event.generation != m_generation) {
+            continue;
+        }
+        handleEnvelope(event);
+    }
+    
+    if (batched) {
+        emit batchFinished();
+    }
 }
 
 void SocketClient::onPingTimeout()
 {
-    if (m_connected && m_authenticated) {
-        sendPing();
+    if (!m_connected || !m_authenticated) {
+        return;
     }
+    
+    qint64 idle = QDateTime::currentMSecsSinceEpoch() - m_lastInboundAt;
+    if (idle < m_pingInterval) {
+        m_pingTimer->start(static_cast<int>(m_pingInterval - idle));
+        return;
+    }
+    
+    sendPing();
+    m_pingTimer->start(m_pingInterval);
 }
 
 void SocketClient::onPongTimeout()
 {
     qWarning() << "[SocketClient] Pong timeout - connection appears dead";
+    
+    // Start over cautiously on the next connection
+    m_pingInterval = kBasePingIntervalMs;
+    m_pingTimeout = kMaxPongTimeoutMs;
     m_socket->close();
 }
 
@@ -424,365 +975,461 @@ void SocketClient::onReconnectTimeout()
 // Envelope handling
 // ============================================================================
 
-void SocketClient::handleEnvelope(const QJsonObject& envelope)
+void SocketClient::handleEnvelope(const SocketEvent& event)
 {
-    QString messageId = envelope["id"].toString();
-    QJsonObject event = envelope["event"].toObject();
-    QJsonObject meta = envelope["meta"].toObject();
+    qDebug() << "[SocketClient] Event:" << event.type;
     
-    QString eventType = event["type"].toString();
-    QJsonObject payload = event["payload"].toObject();
-    QString replyTo = meta["replyTo"].toString();
-    
-    if (eventType.isEmpty()) {
-        qWarning() << "[SocketClient] Received envelope without event type";
+    // Replays can overlap what was already applied before the drop.
+    // 'authenticated' is exempt since a fresh session restarts numbering.
+    if (event.seq > 0 && event.seq <= m_lastEventSeq && event.type != "authenticated") {
+        qDebug() << "[SocketClient] Skipping already applied event seq" << event.seq;
         return;
     }
-    
-    qDebug() << "[SocketClient] Event:" << eventType;
+    if (event.seq > 0) {
+        m_lastEventSeq = event.seq;
+    }
     
     // Check if this is a reply to a pending request
-    if (!replyTo.isEmpty() && m_pendingReplies.contains(replyTo)) {
-        auto callback = m_pendingReplies.take(replyTo);
-        callback(payload);
+    if (!event.replyTo.isEmpty() && m_pendingReplies.contains(event.replyTo)) {
+        auto callback = m_pendingReplies.take(event.replyTo);
+        callback(event.data);
         return;
     }
     
-    handleEvent(eventType, payload, messageId);
+    // Acks for queued sends; the reply itself is still dispatched
+    if (!event.replyTo.isEmpty()) {
+        acknowledge(event.replyTo);
+    }
+    
+    handleEvent(event);
 }
 
-QVariantMap SocketClient::normalizeMessageData(const QVariantMap& data)
+const SocketClient::EventTable& SocketClient::eventTable()
 {
-    QVariantMap normalized = data;
-    
-    // WebSocket API uses 'messageId', but our internal code expects '_id'
-    // Convert for consistency with REST API responses
-    if (normalized.contains("messageId") && !normalized.contains("_id")) {
-        normalized["_id"] = normalized["messageId"];
-    }
-    
-    return normalized;
+    // Built once; read-only afterwards
+    static const EventTable table = buildEventTable();
+    return table;
 }
 
-void SocketClient::handleEvent(const QString& eventType, const QJsonObject& payload,
-                                const QString& messageId)
+SocketClient::EventTable SocketClient::buildEventTable()
 {
-    Q_UNUSED(messageId)
+    EventTable table;
+    table.names.append(QStringLiteral("unknown"));  // Slot 0: unhandled types
     
-    QVariantMap data = payload.toVariantMap();
+    auto add = [&table](const char* type, EventHandler handler) {
+        EventEntry entry;
+        entry.handler = handler;
+        entry.slot = table.names.size();
+        table.names.append(QString::fromLatin1(type));
+        table.entries.insert(table.names.last(), entry);
+    };
     
     // ========================================================================
     // Connection & Authentication
     // ========================================================================
     
-    if (eventType == "authenticated") {
-        m_authenticated = true;
-        QJsonObject user = payload["user"].toObject();
-        m_socketId = user["id"].toString();
+    add("authenticated", [](SocketClient* self, const SocketEvent& e) {
+        self->m_authenticated = true;
+        self->m_reconnectAttempts = 0;  // Only a working session resets the backoff
+        QVariantMap user = e.data["user"].toMap();
+        self->m_socketId = user["id"].toString();
+        
+        // Without a resume the server starts a new sequence
+        self->m_sessionResumed = e.data["resumed"].toBool();
+        self->m_disconnectedAt = 0;
+        if (!self->m_sessionResumed) {
+            self->m_lastEventSeq = e.seq;
+        }
         
-        qDebug() << "[SocketClient] Authenticated as:" << user["username"].toString();
+        qDebug() << "[SocketClient] Authenticated as:" << user["username"].toString()
+                 << (self->m_sessionResumed ? "(session resumed)" : "");
         
-        // Start heartbeat
-        m_pingTimer->start(m_pingInterval);
+        // Start heartbeat (the interval carries over; it's reset on pong timeout)
+        self->m_controlPongSeen = false;
+        self->m_pingSentAt = 0;
+        self->m_lastInboundAt = QDateTime::currentMSecsSinceEpoch();
+        self->m_pingTimer->start(self->m_pingInterval);
         
-        emit socketIdChanged();
-        emit connectedChanged();
-        emit connected();
-    }
-    else if (eventType == "pong") {
+        // Send what was queued while offline, in order, before anything new
+        self->flushOutbox();
+        
+        emit self->socketIdChanged();
+        emit self->connectedChanged();
+        emit self->connected();
+    });
+    add("pong", [](SocketClient* self, const SocketEvent&) {
         // Heartbeat response received
-        qDebug() << "[SocketClient] Pong received";
-    }
-    else if (eventType == "error") {
-        QString code = payload["code"].toString();
-        QString message = payload["message"].toString();
+        self->handlePong(QDateTime::currentMSecsSinceEpoch() - self->m_pingSentAt);
+    });
+    add("error", [](SocketClient* self, const SocketEvent& e) {
+        QString code = e.data["code"].toString();
+        QString message = e.data["message"].toString();
         qWarning() << "[SocketClient] Error:" << code << message;
         
         if (code == "AUTHENTICATION_FAILED" || code == "UNAUTHORIZED") {
-            m_authenticated = false;
-            emit connectedChanged();
+            self->m_authenticated = false;
+            emit self->connectedChanged();
         }
         
-        emit error(message);
-    }
+        emit self->error(message);
+    });
     
     // ========================================================================
     // Direct Messages
     // ========================================================================
     
-    else if (eventType == "message_dm") {
-        emit directMessageReceived(normalizeMessageData(data));
-    }
-    else if (eventType == "message_dm_sent") {
+    add("message_dm", [](SocketClient* self, const SocketEvent& e) {
+        emit self->directMessageReceived(e.data);
+    });
+    add("message_dm_sent", [](SocketClient* self, const SocketEvent& e) {
         // Only emit sent signal - serchatapi.cpp will handle adding to cache
-        emit directMessageSent(normalizeMessageData(data));
-    }
-    else if (eventType == "message_dm_edited") {
-        emit directMessageEdited(normalizeMessageData(data));
-    }
-    else if (eventType == "message_dm_deleted") {
-        emit directMessageDeleted(payload["messageId"].toString());
-    }
-    else if (eventType == "dm_unread_updated") {
-        emit dmUnread(payload["peerId"].toString(), payload["count"].toInt());
-    }
-    else if (eventType == "typing_dm") {
-        emit dmTyping(payload["senderId"].toString(), 
-                      payload["senderUsername"].toString());
-    }
+        emit self->directMessageSent(e.data);
+    });
+    add("message_dm_edited", [](SocketClient* self, const SocketEvent& e) {
+        emit self->directMessageEdited(e.data);
+    });
+    add("message_dm_deleted", [](SocketClient* self, const SocketEvent& e) {
+        emit self->directMessageDeleted(e.data["messageId"].toString());
+    });
+    add("dm_unread_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->dmUnread(e.data["peerId"].toString(), e.data["count"].toInt());
+    });
+    add("typing_dm", [](SocketClient* self, const SocketEvent& e) {
+        emit self->dmTyping(e.data["senderId"].toString(), 
+                            e.data["senderUsername"].toString());
+    });
     
     // ========================================================================
     // Server Messages
     // ========================================================================
     
-    else if (eventType == "message_server") {
-        emit serverMessageReceived(normalizeMessageData(data));
-    }
-    else if (eventType == "message_server_sent") {
+    add("message_server", [](SocketClient* self, const SocketEvent& e) {
+        emit self->serverMessageReceived(e.data);
+    });
+    add("message_server_sent", [](SocketClient* self, const SocketEvent& e) {
         // Only emit sent signal - serchatapi.cpp will handle adding to cache
-        emit serverMessageSent(normalizeMessageData(data));
-    }
-    else if (eventType == "message_server_edited") {
-        emit serverMessageEdited(normalizeMessageData(data));
-    }
-    else if (eventType == "message_server_deleted") {
-        emit serverMessageDeleted(payload["messageId"].toString(),
-                                  payload["channelId"].toString());
-    }
-    else if (eventType == "channel_unread_updated") {
-        emit channelUnread(payload["channelId"].toString(),
-                          payload["lastMessageAt"].toString(),
-                          payload["senderId"].toString());
-    }
-    else if (eventType == "typing_server") {
-        emit userTyping(payload["channelId"].toString(),
-                       payload["senderId"].toString(),
-                       payload["senderUsername"].toString());
-    }
+        emit self->serverMessageSent(e.data);
+    });
+    add("message_server_edited", [](SocketClient* self, const SocketEvent& e) {
+        emit self->serverMessageEdited(e.data);
+    });
+    add("message_server_deleted", [](SocketClient* self, const SocketEvent& e) {
+        emit self->serverMessageDeleted(e.data["messageId"].toString(),
+                                        e.data["channelId"].toString());
+    });
+    add("channel_unread_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->channelUnread(e.data["channelId"].toString(),
+                                 e.data["lastMessageAt"].toString(),
+                                 e.data["senderId"].toString());
+    });
+    add("typing_server", [](SocketClient* self, const SocketEvent& e) {
+        emit self->userTyping(e.data["channelId"].toString(),
+                              e.data["senderId"].toString(),
+                              e.data["senderUsername"].toString());
+    });
     
     // ========================================================================
     // Server & Channel Management
     // ========================================================================
     
-    else if (eventType == "server_joined") {
-        emit serverJoined(payload["serverId"].toString());
-    }
-    else if (eventType == "channel_joined") {
-        emit channelJoined(payload["serverId"].toString(),
-                          payload["channelId"].toString());
-    }
-    else if (eventType == "server_updated") {
-        emit serverUpdated(payload["serverId"].toString(),
-                          payload["server"].toObject().toVariantMap());
-    }
-    else if (eventType == "server_deleted") {
-        emit serverDeleted(payload["serverId"].toString());
-    }
-    else if (eventType == "server_icon_updated") {
-        emit serverIconUpdated(payload["serverId"].toString(),
-                               payload["icon"].toString());
-    }
-    else if (eventType == "server_banner_updated") {
-        emit serverBannerUpdated(payload["serverId"].toString(),
-                                 payload["banner"].toObject().toVariantMap());
-    }
-    else if (eventType == "ownership_transferred") {
-        emit serverOwnershipTransferred(payload["serverId"].toString(),
-                                        payload["oldOwnerId"].toString(),
-                                        payload["newOwnerId"].toString());
-    }
-    else if (eventType == "channel_created") {
-        emit channelCreated(payload["serverId"].toString(),
-                           payload["channel"].toObject().toVariantMap());
-    }
-    else if (eventType == "channel_updated") {
-        emit channelUpdated(payload["serverId"].toString(),
-                           payload["channel"].toObject().toVariantMap());
-    }
-    else if (eventType == "channel_deleted") {
-        emit channelDeleted(payload["serverId"].toString(),
-                           payload["channelId"].toString());
-    }
-    else if (eventType == "channels_reordered") {
-        QVariantList positions;
-        for (const auto& pos : payload["channelPositions"].toArray()) {
-            positions.append(pos.toObject().toVariantMap());
-        }
-        emit channelsReordered(payload["serverId"].toString(), positions);
-    }
-    else if (eventType == "channel_permissions_updated") {
-        emit channelPermissionsUpdated(payload["serverId"].toString(),
-                                       payload["channelId"].toString(),
-                                       payload["permissions"].toObject().toVariantMap());
-    }
+    add("server_joined", [](SocketClient* self, const SocketEvent& e) {
+        emit self->serverJoined(e.data["serverId"].toString());
+    });
+    add("channel_joined", [](SocketClient* self, const SocketEvent& e) {
+        emit self->channelJoined(e.data["serverId"].toString(),
+                                 e.data["channelId"].toString());
+    });
+    add("server_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->serverUpdated(e.data["serverId"].toString(),
+                                 e.data["server"].toMap());
+    });
+    add("server_deleted", [](SocketClient* self, const SocketEvent& e) {
+        emit self->serverDeleted(e.data["serverId"].toString());
+    });
+    add("server_icon_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->serverIconUpdated(e.data["serverId"].toString(),
+                                     e.data["icon"].toString());
+    });
+    add("server_banner_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->serverBannerUpdated(e.data["serverId"].toString(),
+                                       e.data["banner"].toMap());
+    });
+    add("ownership_transferred", [](SocketClient* self, const SocketEvent& e) {
+        emit self->serverOwnershipTransferred(e.data["serverId"].toString(),
+                                              e.data["oldOwnerId"].toString(),
+                                              e.data["newOwnerId"].toString());
+    });
+    add("channel_created", [](SocketClient* self, const SocketEvent& e) {
+        emit self->channelCreated(e.data["serverId"].toString(),
+                                  e.data["channel"].toMap());
+    });
+    add("channel_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->channelUpdated(e.data["serverId"].toString(),
+                                  e.data["channel"].toMap());
+    });
+    add("channel_deleted", [](SocketClient* self, const SocketEvent& e) {
+        emit self->channelDeleted(e.data["serverId"].toString(),
+                                  e.data["channelId"].toString());
+    });
+    add("channels_reordered", [](SocketClient* self, const SocketEvent& e) {
+        QVariantList positions = e.data["channelPositions"].toList();
+        emit self->channelsReordered(e.data["serverId"].toString(), positions);
+    });
+    add("channel_permissions_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->channelPermissionsUpdated(e.data["serverId"].toString(),
+                                             e.data["channelId"].toString(),
+                                             e.data["permissions"].toMap());
+    });
     
     // ========================================================================
     // Categories
     // ========================================================================
     
-    else if (eventType == "category_created") {
-        emit categoryCreated(payload["serverId"].toString(),
-                            payload["category"].toObject().toVariantMap());
-    }
-    else if (eventType == "category_updated") {
-        emit categoryUpdated(payload["serverId"].toString(),
-                            payload["category"].toObject().toVariantMap());
-    }
-    else if (eventType == "category_deleted") {
-        emit categoryDeleted(payload["serverId"].toString(),
-                            payload["categoryId"].toString());
-    }
-    else if (eventType == "categories_reordered") {
-        QVariantList positions;
-        for (const auto& pos : payload["categoryPositions"].toArray()) {
-            positions.append(pos.toObject().toVariantMap());
-        }
-        emit categoriesReordered(payload["serverId"].toString(), positions);
-    }
-    else if (eventType == "category_permissions_updated") {
-        emit categoryPermissionsUpdated(payload["serverId"].toString(),
-                                        payload["categoryId"].toString(),
-                                        payload["permissions"].toObject().toVariantMap());
-    }
+    add("category_created", [](SocketClient* self, const SocketEvent& e) {
+        emit self->categoryCreated(e.data["serverId"].toString(),
+                                   e.data["category"].toMap());
+    });
+    add("category_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->categoryUpdated(e.data["serverId"].toString(),
+                                   e.data["category"].toMap());
+    });
+    add("category_deleted", [](SocketClient* self, const SocketEvent& e) {
+        emit self->categoryDeleted(e.data["serverId"].toString(),
+                                   e.data["categoryId"].toString());
+    });
+    add("categories_reordered", [](SocketClient* self, const SocketEvent& e) {
+        QVariantList positions = e.data["categoryPositions"].toList();
+        emit self->categoriesReordered(e.data["serverId"].toString(), positions);
+    });
+    add("category_permissions_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->categoryPermissionsUpdated(e.data["serverId"].toString(),
+                                              e.data["categoryId"].toString(),
+                                              e.data["permissions"].toMap());
+    });
     
     // ========================================================================
     // Roles
     // ========================================================================
     
-    else if (eventType == "role_created") {
-        emit roleCreated(payload["serverId"].toString(),
-                        payload["role"].toObject().toVariantMap());
-    }
-    else if (eventType == "role_updated") {
-        emit roleUpdated(payload["serverId"].toString(),
-                        payload["role"].toObject().toVariantMap());
-    }
-    else if (eventType == "role_deleted") {
-        emit roleDeleted(payload["serverId"].toString(),
-                        payload["roleId"].toString());
-    }
-    else if (eventType == "roles_reordered") {
-        QVariantList positions;
-        for (const auto& pos : payload["rolePositions"].toArray()) {
-            positions.append(pos.toObject().toVariantMap());
-        }
-        emit rolesReordered(payload["serverId"].toString(), positions);
-    }
+    add("role_created", [](SocketClient* self, const SocketEvent& e) {
+        emit self->roleCreated(e.data["serverId"].toString(),
+                               e.data["role"].toMap());
+    });
+    add("role_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->roleUpdated(e.data["serverId"].toString(),
+                               e.data["role"].toMap());
+    });
+    add("role_deleted", [](SocketClient* self, const SocketEvent& e) {
+        emit self->roleDeleted(e.data["serverId"].toString(),
+                               e.data["roleId"].toString());
+    });
+    add("roles_reordered", [](SocketClient* self, const SocketEvent& e) {
+        QVariantList positions = e.data["rolePositions"].toList();
+        emit self->rolesReordered(e.data["serverId"].toString(), positions);
+    });
     
     // ========================================================================
     // Members
     // ========================================================================
     
-    else if (eventType == "member_added") {
-        emit memberAdded(payload["serverId"].toString(),
-                        payload["userId"].toString());
-    }
-    else if (eventType == "member_removed") {
-        emit memberRemoved(payload["serverId"].toString(),
-                          payload["userId"].toString());
-    }
-    else if (eventType == "member_updated") {
-        emit memberUpdated(payload["serverId"].toString(),
-                          payload["userId"].toString(),
-                          payload["member"].toObject().toVariantMap());
-    }
-    else if (eventType == "member_banned") {
-        emit memberBanned(payload["serverId"].toString(),
-                         payload["userId"].toString());
-    }
-    else if (eventType == "member_unbanned") {
-        emit memberUnbanned(payload["serverId"].toString(),
-                           payload["userId"].toString());
-    }
+    add("member_added", [](SocketClient* self, const SocketEvent& e) {
+        emit self->memberAdded(e.data["serverId"].toString(),
+                               e.data["userId"].toString());
+    });
+    add("member_removed", [](SocketClient* self, const SocketEvent& e) {
+        emit self->memberRemoved(e.data["serverId"].toString(),
+                                 e.data["userId"].toString());
+    });
+    add("member_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->memberUpdated(e.data["serverId"].toString(),
+                                 e.data["userId"].toString(),
+                                 e.data["member"].toMap());
+    });
+    add("member_banned", [](SocketClient* self, const SocketEvent& e) {
+        emit self->memberBanned(e.data["serverId"].toString(),
+                                e.data["userId"].toString());
+    });
+    add("member_unbanned", [](SocketClient* self, const SocketEvent& e) {
+        emit self->memberUnbanned(e.data["serverId"].toString(),
+                                  e.data["userId"].toString());
+    });
     
     // ========================================================================
     // Presence & Profile
     // ========================================================================
     
-    else if (eventType == "presence_sync") {
-        QVariantList onlineUsers;
-        for (const auto& user : payload["online"].toArray()) {
-            onlineUsers.append(user.toObject().toVariantMap());
-        }
-        emit presenceSync(onlineUsers);
-    }
-    else if (eventType == "user_online") {
-        emit userOnline(payload["userId"].toString(),
-                       payload["username"].toString(),
-                       payload["status"].toString());
-    }
-    else if (eventType == "user_offline") {
-        emit userOffline(payload["userId"].toString(),
-                        payload["username"].toString());
-    }
-    else if (eventType == "status_updated") {
-        emit userStatusUpdate(payload["userId"].toString(),
-                             payload["username"].toString(),
-                             payload["status"].toString());
-    }
-    else if (eventType == "user_updated") {
-        emit userUpdated(data);
-    }
-    else if (eventType == "user_banner_updated") {
-        emit userBannerUpdated(payload["username"].toString(),
-                               payload["userId"].toString(),
-                               payload["banner"].toString());
-    }
-    else if (eventType == "display_name_updated") {
-        emit displayNameUpdated(payload["username"].toString(),
-                                payload["userId"].toString(),
-                                payload["displayName"].toString());
-    }
+    add("presence_sync", [](SocketClient* self, const SocketEvent& e) {
+        QVariantList onlineUsers = e.data["online"].toList();
+        emit self->presenceSync(onlineUsers);
+    });
+    add("user_online", [](SocketClient* self, const SocketEvent& e) {
+        emit self->userOnline(e.data["userId"].toString(),
+                              e.data["username"].toString(),
+                              e.data["status"].toString());
+    });
+    add("user_offline", [](SocketClient* self, const SocketEvent& e) {
+        emit self->userOffline(e.data["userId"].toString(),
+                               e.data["username"].toString());
+    });
+    add("status_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->userStatusUpdate(e.data["userId"].toString(),
+                                    e.data["username"].toString(),
+                                    e.data["status"].toString());
+    });
+    add("user_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->userUpdated(e.data);
+    });
+    add("user_banner_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->userBannerUpdated(e.data["username"].toString(),
+                                     e.data["userId"].toString(),
+                                     e.data["banner"].toString());
+    });
+    add("display_name_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->displayNameUpdated(e.data["username"].toString(),
+                                      e.data["userId"].toString(),
+                                      e.data["displayName"].toString());
+    });
     
     // ========================================================================
     // Reactions
     // ========================================================================
     
-    else if (eventType == "reaction_added") {
-        emit reactionAdded(data);
-    }
-    else if (eventType == "reaction_removed") {
-        emit reactionRemoved(data);
-    }
+    add("reaction_added", [](SocketClient* self, const SocketEvent& e) {
+        emit self->reactionAdded(e.data);
+    });
+    add("reaction_removed", [](SocketClient* self, const SocketEvent& e) {
+        emit self->reactionRemoved(e.data);
+    });
     
     // ========================================================================
     // Friends
     // ========================================================================
     
-    else if (eventType == "incoming_request_added") {
-        emit incomingRequestAdded(data);
-    }
-    else if (eventType == "friend_added") {
-        emit friendAdded(payload["friend"].toObject().toVariantMap());
-    }
-    else if (eventType == "friend_removed") {
-        emit friendRemoved(payload["username"].toString(),
-                          payload["userId"].toString());
-    }
+    add("incoming_request_added", [](SocketClient* self, const SocketEvent& e) {
+        emit self->incomingRequestAdded(e.data);
+    });
+    add("friend_added", [](SocketClient* self, const SocketEvent& e) {
+        emit self->friendAdded(e.data["friend"].toMap());
+    });
+    add("friend_removed", [](SocketClient* self, const SocketEvent& e) {
+        emit self->friendRemoved(e.data["username"].toString(),
+                                 e.data["userId"].toString());
+    });
     
     // ========================================================================
     // Notifications
     // ========================================================================
     
-    else if (eventType == "mention") {
-        emit mentionReceived(data);
-    }
+    add("mention", [](SocketClient* self, const SocketEvent& e) {
+        emit self->mentionReceived(e.data);
+    });
     
     // ========================================================================
     // Emoji
     // ========================================================================
     
-    else if (eventType == "emoji_updated") {
-        emit emojiUpdated(payload["serverId"].toString());
+    add("emoji_updated", [](SocketClient* self, const SocketEvent& e) {
+        emit self->emojiUpdated(e.data["serverId"].toString());
+    });
+    
+    return table;
+}
+
+void SocketClient::handleEvent(const SocketEvent& event)
+{
+    const EventTable& table = eventTable();
+    QHash<QString, EventEntry>::const_iterator it = table.entries.constFind(event.type);
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    int slot = 0;
+    if (it != table.entries.constEnd()) {
+        slot = it->slot;
+        it->handler(this, event);
+    } else {
+        qDebug() << "[SocketClient] Unknown event:" << event.type << event.data;
     }
     
-    // ========================================================================
-    // Unknown event
-    // ========================================================================
+    recordEventTiming(slot, timer.nsecsElapsed());
+}
+
+// ============================================================================
+// Event statistics
+// ============================================================================
+
+void SocketClient::recordEventTiming(int slot, qint64 nsecs)
+{
+    if (m_eventStats.size() <= slot) {
+        m_eventStats.resize(eventTable().names.size());
+    }
+    
+    EventStats& stats = m_eventStats[slot];
+    stats.count++;
+    stats.totalNs += nsecs;
+    stats.maxNs = qMax(stats.maxNs, nsecs);
+    
+    int bucket = 0;
+    qint64 usecs = nsecs / 1000;
+    while (bucket < kTimingBuckets - 1 && usecs >= kTimingBucketBoundsUs[bucket]) {
+        bucket++;
+    }
+    stats.histogram[bucket]++;
+}
+
+QVariantMap SocketClient::eventStats() const
+{
+    const EventTable& table = eventTable();
+    
+    QVariantList events;
+    qint64 totalNs = 0;
+    quint64 totalCount = 0;
+    for (int slot = 0; slot < m_eventStats.size(); ++slot) {
+        const EventStats& stats = m_eventStats.at(slot);
+        if (stats.count == 0) {
+            continue;
+        }
+        
+        QVariantList histogram;
+        for (int i = 0; i < kTimingBuckets; ++i) {
+            histogram.append(stats.histogram[i]);
+        }
+        
+        QVariantMap entry;
+        entry["type"] = table.names.at(slot);
+        entry["count"] = stats.count;
+        entry["totalMs"] = stats.totalNs / 1e6;
+        entry["avgUs"] = stats.totalNs / 1e3 / stats.count;
+        entry["maxUs"] = stats.maxNs / 1e3;
+        entry["histogram"] = histogram;
+        events.append(entry);
+        
+        totalNs += stats.totalNs;
+        totalCount += stats.count;
+    }
     
-    else {
-        qDebug() << "[SocketClient] Unknown event:" << eventType << data;
+    // Most expensive event types first
+    std::sort(events.begin(), events.end(), [](const QVariant& a, const QVariant& b) {
+        return a.toMap().value("totalMs").toDouble() > b.toMap().value("totalMs").toDouble();
+    });
+    
+    QStringList buckets;
+    for (int i = 0; i < kTimingBuckets - 1; ++i) {
+        buckets.append(QString("<%1us").arg(kTimingBucketBoundsUs[i]));
     }
+    buckets.append(QString(">=%1us").arg(kTimingBucketBoundsUs[kTimingBuckets - 2]));
+    
+    QVariantMap result;
+    result["events"] = events;
+    result["buckets"] = buckets;
+    result["totalCount"] = totalCount;
+    result["totalMs"] = totalNs / 1e6;
+    return result;
+}
+
+void SocketClient::resetEventStats()
+{
+    m_eventStats.clear();
 }
 
 // ============================================================================
@@ -791,18 +1438,41 @@ void SocketClient::handleEvent(const QString& eventType, const QJsonObject& payl
 
 void SocketClient::scheduleReconnect()
 {
-    if (!m_shouldReconnect || m_reconnectAttempts >= m_maxReconnectAttempts) {
+    if (!m_shouldReconnect) {
+        return;
+    }
+    if (m_reconnectAttempts >= m_maxReconnectAttempts && !m_keepTrying) {
+        qWarning() << "[SocketClient] Giving up after" << m_reconnectAttempts << "reconnect attempts";
         return;
     }
     
-    // Exponential backoff: 1s, 2s, 4s, 8s... up to 30s
-    int delay = qMin(1000 * (1 << m_reconnectAttempts), 30000);
+    int delay = reconnectDelay(m_reconnectAttempts);
+    if (!m_networkOnline) {
+        // Only a hint - the "online" change may never be delivered - so
+        // keep probing at the slow keep-trying pace instead of stopping
+        delay = qMax(delay, reconnectDelay(m_maxReconnectAttempts));
+        qDebug() << "[SocketClient] Network reported offline, retrying slowly";
+    }
     qDebug() << "[SocketClient] Scheduling reconnect in" << delay << "ms";
     
     emit reconnecting(m_reconnectAttempts + 1);
     m_reconnectTimer->start(delay);
 }
 
+int SocketClient::reconnectDelay(int attempt) const
+{
+    int base = kKeepTryingMs;
+    if (attempt < m_maxReconnectAttempts) {
+        // Exponential backoff: 1s, 2s, 4s, 8s... up to 30s
+        base = qMin(kReconnectBaseMs << qMin(attempt, 15), kReconnectMaxMs);
+    }
+    
+    // Anywhere in [base/2, base] so clients dropped by the same server
+    // blip don't all come back in lockstep
+    int half = base / 2;
+    return half + QRandomGenerator::global()->bounded(half + 1);
+}
+
 void SocketClient::attemptReconnect()
 {
     if (!m_shouldReconnect) return;
@@ -810,5 +1480,6 @@ void SocketClient::attemptReconnect()
     m_reconnectAttempts++;
     qDebug() << "[SocketClient] Reconnect attempt" << m_reconnectAttempts;
     
-    connect(m_url, m_authToken);
+    // Not connect(): that would reset the attempt counter
+    openSocket();
 }
@@ -11,6 +11,15 @@
 #include <QUrl>
 #include <QPointer>
 #include <QUuid>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include "jsonwriter.h"
+
+class QThread;
+class QNetworkConfigurationManager;
+class SocketDecoder;
+struct SocketEvent;
 
 /**
  * @brief Pure WebSocket client for Serchat API.
@@ -22,7 +31,27 @@
  * - Connection: Standard WebSocket to /ws endpoint
  * - Authentication: Send 'authenticate' event with JWT within 30s grace period
  * - Wire Format: All messages use IWsEnvelope structure with id, event, and meta
- * - Heartbeat: Client sends 'ping', server responds with 'pong'
+ * - Encoding: JSON text frames by default. With binary transport enabled the
+ *   client asks for CBOR (?encoding=cbor) and switches its own frames to CBOR
+ *   once the server answers in binary; servers that ignore the request keep
+ *   talking JSON and so does the client
+ * - Outbound queue: Events are queued and sent in order once authenticated,
+ *   so sends made while reconnecting aren't lost. Event types the server
+ *   acks (meta.replyTo) are resent with the same envelope ID until acked;
+ *   other types are kept until a pong to a later ping proves the server
+ *   read them, and go out again after a reconnect otherwise.
+ *   Typing pings and read markers are coalesced to the latest one.
+ * - Resumption: The last applied event sequence is sent with 'authenticate'
+ *   on reconnect; if the server can replay from there it answers with
+ *   "resumed": true and sessionResumed() is set for that connection
+ * - Heartbeat: Client sends 'ping', server responds with 'pong'. WebSocket
+ *   control-frame pings are used once the server has answered one. Pings
+ *   are skipped while other traffic arrives, the interval stretches from
+ *   25s up to 45s on a stable link, and the pong timeout follows the RTT.
+ * - Decoding: Incoming frames are parsed on a worker thread (SocketDecoder);
+ *   the GUI thread only dispatches the decoded events
+ * - Dispatch: One handler per event type, looked up in a table built once;
+ *   per-type counts and handler timings are available via eventStats()
  * 
  * Wire Format (IWsEnvelope):
  * {
@@ -33,6 +62,7 @@
  *     },
  *     "meta": {
  *         "replyTo": "uuid",  // Optional: ID of request being replied to
+ *         "seq": 42,          // Optional: server event sequence number
  *         "ts": 1234567890    // Unix timestamp in ms
  *     }
  * }
@@ -50,6 +80,48 @@ public:
     bool isConnected() const { return m_connected && m_authenticated; }
     QString socketId() const { return m_socketId; }
 
+    /// True if the current connection resumed the previous session, i.e.
+    /// the server replays missed events and a full resync isn't needed
+    bool sessionResumed() const { return m_sessionResumed; }
+
+    /// Forget the event sequence so the next connect starts a fresh session
+    void resetSession();
+
+    /// Number of buckets in the handler timing histogram
+    static const int kTimingBuckets = 8;
+
+    /**
+     * @brief Per-event-type dispatch statistics since start (or last reset).
+     *
+     * Returns { events: [{ type, count, totalMs, avgUs, maxUs, histogram }],
+     * buckets: [labels], totalCount, totalMs }, most expensive type first.
+     * Histogram counts line up with the bucket labels.
+     */
+    Q_INVOKABLE QVariantMap eventStats() const;
+
+    /// Clear the counters behind eventStats()
+    Q_INVOKABLE void resetEventStats();
+
+    /**
+     * @brief Opt-in event batching.
+     *
+     * With a window >= 0, decoded events are collected for that many ms
+     * (0 = until the next event loop pass) and dispatched together between
+     * batchStarted() and batchFinished(), so listeners can apply a whole
+     * burst in one pass. Negative (the default) dispatches events as soon
+     * as they are decoded, without batch signals.
+     */
+    void setBatchWindow(int msecs);
+    int batchWindow() const { return m_batchWindow; }
+
+    /**
+     * @brief Request the CBOR binary encoding on the next connect().
+     * JSON stays the fallback whenever the server doesn't answer in CBOR.
+     * Requires Qt 5.12 (QCborValue); ignored on older Qt.
+     */
+    void setBinaryTransport(bool enabled);
+    bool binaryTransport() const { return m_binaryTransport; }
+
 public slots:
     /// Connect to a WebSocket server
     void connect(const QString& url, const QString& authToken = QString());
@@ -60,11 +132,21 @@ public slots:
     /// Reset reconnection attempts counter (call before reconnecting after app resume)
     void resetReconnectAttempts();
 
+    /// Skip any pending backoff and reconnect right away (e.g. app activated).
+    /// Returns false if there is nothing to reconnect (never connected,
+    /// explicitly disconnected, or already connected); true if an attempt
+    /// was started or is already underway.
+    bool reconnectNow();
+
+    /// Keep retrying (slowly) after the normal attempt limit instead of giving up
+    void setKeepTrying(bool keepTrying);
+
     /// Check if the connection is truly alive by sending a ping
-    /// If no response within timeout, the connection will be closed and reconnected
+    /// If no response within timeout, the connection will be closed and reconnected.
+    /// While waiting to reconnect, reconnects immediately instead.
     void checkConnectionHealth();
 
-    /// Emit an event to the server
+    /// Emit an event to the server (queued while disconnected)
     void emitEvent(const QString& eventType, const QVariantMap& payload = {});
     
     /// Join a room (emits 'join_server' or 'join_channel' event)
@@ -111,11 +193,18 @@ signals:
     void socketIdChanged();
     void error(const QString& message);
     
+    /// A queued event was dropped (queue overflow or never acked)
+    void sendFailed(const QString& eventType, const QVariantMap& payload);
+    
     // Connection events
     void connected();
     void disconnected();
     void reconnecting(int attempt);
     
+    // Event batching (only when a batch window is set)
+    void batchStarted();
+    void batchFinished();
+    
     // Server message events
     void serverMessageReceived(const QVariantMap& message);
     void serverMessageSent(const QVariantMap& message);
@@ -208,28 +297,74 @@ private slots:
     void onWebSocketDisconnected();
     void onWebSocketError(QAbstractSocket::SocketError error);
     void onTextMessageReceived(const QString& message);
+    void onBinaryMessageReceived(const QByteArray& message);
+    void onEventsReady();
+    void dispatchReadyEvents();
     void onPingTimeout();
     void onPongTimeout();
     void onReconnectTimeout();
+    void onNetworkOnlineChanged(bool online);
+    void onControlPong(quint64 elapsedTime, const QByteArray& payload);
+    void onAckTimeout();
 
 private:
-    /// Generate a new UUID for message ID
+    /// Next envelope ID: per-connection random prefix + counter
     QString generateMessageId();
+    static QString newIdPrefix();
     
-    /// Send a message in envelope format
-    void sendEnvelope(const QString& eventType, const QVariantMap& payload, 
-                      const QString& replyTo = QString());
+    /// Restart heartbeat bookkeeping after any inbound frame
+    void noteInboundTraffic();
     
-    /// Handle incoming envelope
-    void handleEnvelope(const QJsonObject& envelope);
+    /// Send a message in envelope format (immediately; dropped if not connected)
+    /// payload is an encoded JSON object (empty = {})
+    void sendEnvelope(const QString& eventType, const QByteArray& payload, 
+                      const QString& replyTo = QString(),
+                      const QString& envelopeId = QString());
     
-    /// Handle event from envelope
-    void handleEvent(const QString& eventType, const QJsonObject& payload, 
-                     const QString& messageId);
+    /// Serialize an envelope as JSON text (UTF-8, into m_frameWriter) or CBOR
+    QByteArray encodeEnvelope(const QString& eventType, const QByteArray& payload,
+                              const QString& replyTo, const QString& envelopeId,
+                              bool binary);
+    
+    /// Encoded payload back to a map (for sendFailed())
+    static QVariantMap decodePayload(const QByteArray& payload);
+    
+    /// Queue an event for sending. A non-empty coalesceKey replaces any
+    /// unsent event with the same key; maxAgeMs > 0 drops it if not sent in time.
+    void queueEvent(const QString& eventType, const QByteArray& payload,
+                    const QString& coalesceKey = QString(), int maxAgeMs = 0);
+    void flushOutbox();
+    bool acknowledge(const QString& envelopeId);
+    /// Drop sends of never-acked types written before the ping now answered
+    void confirmWrittenBefore(qint64 pingSentAt);
     
-    /// Normalize message data from WebSocket format to internal format
-    /// Converts messageId -> _id for consistency with REST API
-    QVariantMap normalizeMessageData(const QVariantMap& data);
+    /// Handle decoded envelope (replies first, then events)
+    void handleEnvelope(const SocketEvent& event);
+    
+    /// Handle event from envelope
+    void handleEvent(const SocketEvent& event);
+    
+    // Event dispatch table
+    typedef void (*EventHandler)(SocketClient* self, const SocketEvent& event);
+    struct EventEntry {
+        EventHandler handler = nullptr;
+        int slot = 0;        // Index into names / m_eventStats
+    };
+    struct EventTable {
+        QHash<QString, EventEntry> entries;
+        QVector<QString> names;  // Slot -> event type, slot 0 is "unknown"
+    };
+    static const EventTable& eventTable();
+    static EventTable buildEventTable();
+    
+    // Event statistics
+    struct EventStats {
+        quint64 count = 0;
+        qint64 totalNs = 0;
+        qint64 maxNs = 0;
+        quint32 histogram[kTimingBuckets] = {};
+    };
+    void recordEventTiming(int slot, qint64 nsecs);
     
     /// Send authentication
     void sendAuthentication();
@@ -237,9 +372,16 @@ private:
     /// Send ping heartbeat
     void sendPing();
     
+    /// A ping was answered after roundTripMs; adapts interval and timeout
+    void handlePong(qint64 roundTripMs);
+    
+    /// Open the WebSocket for m_url (fresh connection state, same session)
+    void openSocket();
+    
     // Reconnection
     void scheduleReconnect();
     void attemptReconnect();
+    int reconnectDelay(int attempt) const;
     
     QWebSocket* m_socket;
     QString m_url;
@@ -251,17 +393,67 @@ private:
     // Heartbeat
     QTimer* m_pingTimer;
     QTimer* m_pongTimeoutTimer;
-    int m_pingInterval;
-    int m_pingTimeout;
+    int m_pingInterval;      // Current quiet period before a ping
+    int m_pingTimeout;       // Current wait for the pong
+    qint64 m_lastInboundAt;  // Last frame received (ms since epoch)
+    qint64 m_pingSentAt;
+    bool m_controlPongSeen;  // Server answers control-frame pings on this connection
     
     // Reconnection
     QTimer* m_reconnectTimer;
     int m_reconnectAttempts;
-    int m_maxReconnectAttempts;
+    int m_maxReconnectAttempts;  // Backoff grows until here; then give up or keep trying
     bool m_shouldReconnect;
+    bool m_keepTrying;
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+    QNetworkConfigurationManager* m_networkConfig;
+#endif
+    bool m_networkOnline;        // Bearer hint; only slows reconnects down
+    
+    // Frame decoding (worker thread)
+    QThread* m_decoderThread;
+    SocketDecoder* m_decoder;
+    quint64 m_generation;    // Bumped per connection; stale decoded events are dropped
+    
+    // Wire encoding
+    bool m_binaryTransport;  // Ask the server for CBOR
+    bool m_peerUsesCbor;     // Server sent CBOR on this connection
+    
+    // Event batching
+    QTimer* m_batchTimer;
+    int m_batchWindow;       // < 0: disabled
+    
+    // Dispatch statistics, indexed by event table slot
+    QVector<EventStats> m_eventStats;
+    
+    // Session resumption
+    qint64 m_lastEventSeq;   // Last applied meta.seq (0 = none)
+    qint64 m_disconnectedAt; // When the last session dropped (ms since epoch, 0 = live)
+    bool m_sessionResumed;
+    
+    // Outbound queue
+    struct OutboundEvent {
+        QString id;              // Envelope ID, reused on resend
+        QString type;
+        QByteArray payload;      // Encoded JSON object
+        QString coalesceKey;
+        qint64 expiresAt = 0;    // 0 = never
+        qint64 sentAt = 0;       // 0 = not on the wire
+        int attempts = 0;
+    };
+    QList<OutboundEvent> m_outbox;
+    QTimer* m_ackTimer;
+    QSet<QString> m_ackedTypes;  // Event types the server acks (meta.replyTo)
+    
+    // Envelope IDs
+    QString m_idPrefix;
+    quint64 m_idCounter;
+    
+    // Reused for every outbound JSON frame
+    JsonWriter m_frameWriter;
     
     // Pending replies tracking
-    QMap<QString, std::function<void(const QJsonObject&)>> m_pendingReplies;
+    QMap<QString, std::function<void(const QVariantMap&)>> m_pendingReplies;
 };
 
 #endif // SOCKETCLIENT_H
@@ -0,0 +1,158 @@
+#include "socketdecoder.h"
+#include <QDebug>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QSet>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+#include <QCborMap>
+#include <QCborValue>
+#endif
+
+SocketDecoder::SocketDecoder(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QQueue<SocketEvent> SocketDecoder::takeReady()
+{
+    QQueue<SocketEvent> ready;
+    QMutexLocker locker(&m_mutex);
+    ready.swap(m_ready);
+    return ready;
+}
+
+void SocketDecoder::decode(quint64 generation, const QString& frame)
+{
+    SocketEvent event;
+    if (decodeFrame(frame, event)) {
+        enqueue(generation, event);
+    }
+}
+
+void SocketDecoder::decodeBinary(quint64 generation, const QByteArray& frame)
+{
+    SocketEvent event;
+    if (decodeBinaryFrame(frame, event)) {
+        enqueue(generation, event);
+    }
+}
+
+void SocketDecoder::enqueue(quint64 generation, const SocketEvent& event)
+{
+    bool wasEmpty;
+    {
+        QMutexLocker locker(&m_mutex);
+        wasEmpty = m_ready.isEmpty();
+        m_ready.enqueue(event);
+        m_ready.last().generation = generation;
+    }
+
+    // The owner drains the whole queue per wakeup, so only the first
+    // event of a burst needs to wake it
+    if (wasEmpty) {
+        emit eventsReady();
+    }
+}
+
+bool SocketDecoder::decodeFrame(const QString& frame, SocketEvent& out)
+{
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(frame.toUtf8(), &parseError);
+
+    if (parseError.error != QJsonParseError::NoError) {
+        qWarning() << "[SocketClient] JSON parse error:" << parseError.errorString();
+        return false;
+    }
+
+    if (!doc.isObject()) {
+        qWarning() << "[SocketClient] Expected JSON object envelope";
+        return false;
+    }
+
+    return decodeEnvelope(doc.object(), out);
+}
+
+bool SocketDecoder::decodeBinaryFrame(const QByteArray& frame, SocketEvent& out)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    QCborParserError parseError;
+    QCborValue value = QCborValue::fromCbor(frame, &parseError);
+
+    if (parseError.error != QCborError::NoError) {
+        qWarning() << "[SocketClient] CBOR parse error:" << parseError.errorString();
+        return false;
+    }
+
+    if (!value.isMap()) {
+        qWarning() << "[SocketClient] Expected CBOR map envelope";
+        return false;
+    }
+
+    // Same envelope as JSON, read straight into variants without a
+    // detour through QJsonObject
+    QCborMap envelope = value.toMap();
+    QCborMap event = envelope.value(QStringLiteral("event")).toMap();
+    QCborMap meta = envelope.value(QStringLiteral("meta")).toMap();
+
+    out.id = envelope.value(QStringLiteral("id")).toString();
+    out.type = event.value(QStringLiteral("type")).toString();
+    out.replyTo = meta.value(QStringLiteral("replyTo")).toString();
+    QCborValue seq = meta.value(QStringLiteral("seq"));
+    out.seq = seq.isDouble() ? static_cast<qint64>(seq.toDouble()) : seq.toInteger();
+    out.data = event.value(QStringLiteral("payload")).toMap().toVariantMap();
+
+    return finishEvent(out);
+#else
+    Q_UNUSED(frame)
+    Q_UNUSED(out)
+    qWarning() << "[SocketClient] Binary frame ignored, CBOR needs Qt 5.12";
+    return false;
+#endif
+}
+
+bool SocketDecoder::decodeEnvelope(const QJsonObject& envelope, SocketEvent& out)
+{
+    QJsonObject event = envelope["event"].toObject();
+
+    out.id = envelope["id"].toString();
+    out.type = event["type"].toString();
+    QJsonObject meta = envelope["meta"].toObject();
+    out.replyTo = meta["replyTo"].toString();
+    out.seq = static_cast<qint64>(meta["seq"].toDouble());
+    out.data = event["payload"].toObject().toVariantMap();
+
+    return finishEvent(out);
+}
+
+bool SocketDecoder::finishEvent(SocketEvent& out)
+{
+    if (out.type.isEmpty()) {
+        qWarning() << "[SocketClient] Received envelope without event type";
+        return false;
+    }
+
+    // Message events carry a message object that the rest of the app
+    // expects in REST shape
+    static const QSet<QString> messageEvents = {
+        "message_dm", "message_dm_sent", "message_dm_edited",
+        "message_server", "message_server_sent", "message_server_edited"
+    };
+
+    if (messageEvents.contains(out.type)) {
+        out.data = normalizeMessageData(out.data);
+    }
+    return true;
+}
+
+QVariantMap SocketDecoder::normalizeMessageData(const QVariantMap& data)
+{
+    QVariantMap normalized = data;
+
+    // WebSocket API uses 'messageId', but our internal code expects '_id'
+    // Convert for consistency with REST API responses
+    if (normalized.contains("messageId") && !normalized.contains("_id")) {
+        normalized["_id"] = normalized["messageId"];
+    }
+
+    return normalized;
+}
@@ -0,0 +1,81 @@
+#ifndef SOCKETDECODER_H
+#define SOCKETDECODER_H
+
+#include <QObject>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QJsonObject>
+#include <QVariantMap>
+
+/**
+ * @brief A fully decoded WebSocket envelope, ready to be dispatched.
+ *
+ * Everything that costs more than a field lookup (UTF-8 conversion, JSON
+ * parsing, QVariant conversion, message normalization) has already been
+ * done by the time one of these reaches the GUI thread.
+ */
+struct SocketEvent {
+    quint64 generation = 0;  // Connection the frame arrived on
+    QString id;              // Envelope ID
+    QString type;            // event.type
+    QString replyTo;         // meta.replyTo, if any
+    qint64 seq = 0;          // meta.seq, server event sequence (0 = none)
+    QVariantMap data;        // event.payload (normalized for messages)
+};
+
+/**
+ * @brief Decodes SocketClient frames on a worker thread.
+ *
+ * SocketClient hands raw text frames to decode() through a queued call;
+ * the decoder parses them in arrival order and appends the results to a
+ * ready queue. eventsReady() is emitted only when that queue goes from
+ * empty to non-empty, so a burst of frames costs the GUI thread a single
+ * wakeup, after which it drains everything with takeReady().
+ *
+ * Text frames are JSON; binary frames are CBOR (same envelope structure,
+ * Qt 5.12+ only).
+ *
+ * Lives on its own thread - all members except decode() are called from
+ * the owner's thread.
+ */
+class SocketDecoder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SocketDecoder(QObject *parent = nullptr);
+
+    /// Take every decoded event queued so far (oldest first)
+    QQueue<SocketEvent> takeReady();
+
+    /// Convert messageId -> _id for consistency with REST API responses
+    static QVariantMap normalizeMessageData(const QVariantMap& data);
+
+public slots:
+    /// Decode a JSON text frame on the worker thread and queue the result
+    void decode(quint64 generation, const QString& frame);
+
+    /// Decode a CBOR binary frame on the worker thread and queue the result
+    void decodeBinary(quint64 generation, const QByteArray& frame);
+
+signals:
+    /// The ready queue became non-empty
+    void eventsReady();
+
+private:
+    /// Parse a frame into an event; false if it isn't a usable envelope
+    static bool decodeFrame(const QString& frame, SocketEvent& out);
+    static bool decodeBinaryFrame(const QByteArray& frame, SocketEvent& out);
+    static bool decodeEnvelope(const QJsonObject& envelope, SocketEvent& out);
+    
+    /// Checks and normalization shared by both encodings
+    static bool finishEvent(SocketEvent& out);
+
+    void enqueue(quint64 generation, const SocketEvent& event);
+
+    QMutex m_mutex;
+    QQueue<SocketEvent> m_ready;
+};
+
+#endif // SOCKETDECODER_H
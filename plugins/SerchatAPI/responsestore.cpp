@@ -0,0 +1,179 @@
+#include "responsestore.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QCryptographicHash>
+#include <QDebug>
+
+namespace {
+const quint32 kMagic = 0x53435253;  // "SCRS"
+const quint16 kVersion = 1;
+const QDataStream::Version kStreamVersion = QDataStream::Qt_5_9;
+}
+
+void ResponseStore::setDirectory(const QString& path) {
+    m_directory = path;
+    m_totalBytes = -1;
+    if (!m_directory.isEmpty()) {
+        QDir().mkpath(m_directory);
+    }
+}
+
+void ResponseStore::setLimits(qint64 maxBytes, int maxAgeSeconds) {
+    m_maxBytes = maxBytes;
+    m_maxAgeSeconds = maxAgeSeconds;
+}
+
+QString ResponseStore::filePath(const QString& key) const {
+    // Cache keys contain ':' and IDs; hash them into safe file names
+    return m_directory + "/" + QString::fromLatin1(
+        QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex()) + ".resp";
+}
+
+bool ResponseStore::load(const QString& key, Entry& out) const {
+    if (!isEnabled() || key.isEmpty()) {
+        return false;
+    }
+
+    QFile file(filePath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(kStreamVersion);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != kMagic || version != kVersion) {
+        qWarning() << "ResponseStore: Ignoring incompatible entry for" << key;
+        return false;
+    }
+
+    QString storedKey;
+    Entry entry;
+    in >> storedKey >> entry.storedAt >> entry.etag >> entry.lastModified >> entry.data;
+    if (in.status() != QDataStream::Ok || storedKey != key) {
+        qWarning() << "ResponseStore: Unreadable entry for" << key;
+        return false;
+    }
+
+    if (!entry.storedAt.isValid()
+            || entry.storedAt.secsTo(QDateTime::currentDateTimeUtc()) > m_maxAgeSeconds) {
+        file.close();
+        remove(key);
+        return false;
+    }
+
+    out = entry;
+    return true;
+}
+
+bool ResponseStore::save(const QString& key, const Entry& entry) {
+    if (!isEnabled() || key.isEmpty()) {
+        return false;
+    }
+
+    QSaveFile file(filePath(key));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "ResponseStore: Cannot write entry for" << key << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(kStreamVersion);
+    out << kMagic << kVersion << key << entry.storedAt.toUTC()
+        << entry.etag << entry.lastModified << entry.data;
+
+    if (out.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    qint64 size = file.size();
+    if (!file.commit()) {
+        return false;
+    }
+
+    // Overwrites are counted twice; prune() rescans before deleting anything
+    if (m_totalBytes >= 0) {
+        m_totalBytes += size;
+    }
+    if (m_totalBytes < 0 || m_totalBytes > m_maxBytes) {
+        prune();
+    }
+    return true;
+}
+
+bool ResponseStore::touch(const QString& key, const QDateTime& storedAt) {
+    if (!isEnabled() || key.isEmpty()) {
+        return false;
+    }
+
+    // Unbuffered so the write lands right after what was read
+    QFile file(filePath(key));
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Unbuffered)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(kStreamVersion);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    QString storedKey;
+    stream >> magic >> version >> storedKey;
+    if (stream.status() != QDataStream::Ok || magic != kMagic || version != kVersion
+            || storedKey != key) {
+        return false;
+    }
+
+    // storedAt is always written as UTC, so its encoding has a fixed size
+    stream << storedAt.toUTC();
+    return stream.status() == QDataStream::Ok;
+}
+
+void ResponseStore::remove(const QString& key) const {
+    if (!isEnabled() || key.isEmpty()) {
+        return;
+    }
+    QFile::remove(filePath(key));
+}
+
+void ResponseStore::clear() {
+    if (!isEnabled()) {
+        return;
+    }
+
+    QDir dir(m_directory);
+    const QStringList files = dir.entryList(QStringList() << "*.resp", QDir::Files);
+    for (const QString& name : files) {
+        dir.remove(name);
+    }
+    m_totalBytes = 0;
+}
+
+void ResponseStore::prune() {
+    QDir dir(m_directory);
+    // Newest first
+    const QFileInfoList files = dir.entryInfoList(QStringList() << "*.resp", QDir::Files, QDir::Time);
+
+    qint64 total = 0;
+    for (const QFileInfo& info : files) {
+        total += info.size();
+    }
+
+    // Drop the least recently written files down to 3/4 of the limit so
+    // this doesn't run again on the very next write
+    if (total > m_maxBytes) {
+        qint64 target = m_maxBytes * 3 / 4;
+        for (int i = files.size() - 1; i >= 0 && total > target; --i) {
+            total -= files.at(i).size();
+            dir.remove(files.at(i).fileName());
+        }
+        qDebug() << "ResponseStore: Pruned to" << total << "bytes";
+    }
+    m_totalBytes = total;
+}
@@ -0,0 +1,82 @@
+#ifndef RESPONSESTORE_H
+#define RESPONSESTORE_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+#include <QVariantMap>
+
+/**
+ * @brief Persistent tier behind ApiClient's in-memory response cache.
+ *
+ * Lets the server list, channels, roles and emoji metadata be shown right
+ * after a cold start, before any network round trip. Each cache key is one
+ * compact binary file (QDataStream) under the configured directory, written
+ * atomically via QSaveFile. Entries older than the max age are dropped when
+ * read; once the directory grows past the size limit the least recently
+ * written files are deleted.
+ *
+ * File layout (version 1):
+ *   quint32 magic, quint16 version, QString key, QDateTime storedAt,
+ *   QByteArray etag, QByteArray lastModified, QVariantMap data
+ */
+class ResponseStore {
+public:
+    struct Entry {
+        QVariantMap data;
+        QDateTime storedAt;
+        QByteArray etag;
+        QByteArray lastModified;
+    };
+
+    ResponseStore() = default;
+
+    /**
+     * @brief Set the directory entries live in. Empty disables the store.
+     */
+    void setDirectory(const QString& path);
+    QString directory() const { return m_directory; }
+    bool isEnabled() const { return !m_directory.isEmpty(); }
+
+    /**
+     * @brief Limit total size on disk and how old an entry may be when read.
+     */
+    void setLimits(qint64 maxBytes, int maxAgeSeconds);
+
+    /**
+     * @brief Read an entry. Returns false if missing, unreadable or too old.
+     */
+    bool load(const QString& key, Entry& out) const;
+
+    /**
+     * @brief Write an entry, replacing any previous one for the key.
+     */
+    bool save(const QString& key, const Entry& entry);
+
+    /**
+     * @brief Overwrite only the storedAt of an existing entry, leaving the
+     * rest of the file alone. Returns false if there is no readable entry.
+     */
+    bool touch(const QString& key, const QDateTime& storedAt);
+
+    /**
+     * @brief Delete a single entry.
+     */
+    void remove(const QString& key) const;
+
+    /**
+     * @brief Delete all entries (e.g. on logout).
+     */
+    void clear();
+
+private:
+    QString m_directory;
+    qint64 m_maxBytes = 4 * 1024 * 1024;
+    int m_maxAgeSeconds = 7 * 24 * 3600;
+    qint64 m_totalBytes = -1;  // Approximate size on disk; -1 = not scanned yet
+
+    QString filePath(const QString& key) const;
+    void prune();
+};
+
+#endif // RESPONSESTORE_H
@@ -56,6 +56,21 @@ SerchatAPI::SerchatAPI() {
     // Connect MessageModel to UserProfileCache for sender name/avatar lookups
     m_messageModel->setUserProfileCache(m_userProfileCache);
 
+    // Keep the model's "NEW MESSAGES" row in sync with the unread tracking
+    connect(this, &SerchatAPI::firstUnreadMessageIdChanged, m_messageModel,
+            [this](const QString& serverId, const QString& channelId, const QString& messageId) {
+        if (!m_messageModel->isDMMode() && m_messageModel->serverId() == serverId
+                && m_messageModel->channelId() == channelId) {
+            m_messageModel->setFirstUnreadMessageId(messageId);
+        }
+    });
+    connect(m_messageModel, &MessageModel::channelIdChanged, this, [this]() {
+        if (!m_messageModel->isDMMode()) {
+            m_messageModel->setFirstUnreadMessageId(
+                getFirstUnreadMessageId(m_messageModel->serverId(), m_messageModel->channelId()));
+        }
+    });
+
     // Configure base URLs
     QString baseUrl = apiBaseUrl();
     m_authClient->setBaseUrl(baseUrl);
@@ -70,6 +85,26 @@ SerchatAPI::SerchatAPI() {
     m_channelCache->setApiClient(m_apiClient);
     m_messageCache->setApiClient(m_apiClient);
 
+    // Persist message snapshots so channels paint instantly after a cold start
+    m_messageCache->setStorageDirectory(
+        QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/messages");
+
+    // Same for the server list, channels, roles and emoji metadata
+    m_apiClient->setPersistentCacheDirectory(
+        QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/responses");
+
+    // Latest message pages are revalidated by ETag, but their bodies live in
+    // MessageCache rather than a second copy in ApiClient
+    m_apiClient->setNotModifiedSource([this](const QString&, const QVariantMap& context, QVariantMap& outData) {
+        QVariantList messages;
+        if (!m_messageCache->latestPage(context.value("channelId").toString(),
+                                        context.value("limit").toInt(), messages)) {
+            return false;
+        }
+        outData["items"] = messages;
+        return true;
+    });
+
     // Configure markdown parser with base URL
     m_markdownParser->setBaseUrl(baseUrl);
 
@@ -196,6 +231,11 @@ SerchatAPI::SerchatAPI() {
                 m_emojiCache->loadAllEmojis(emojis);
                 emit allEmojisFetched(requestId, emojis);
             });
+    connect(m_apiClient, &ApiClient::allEmojisBatchFetched,
+            this, [this](int, const QVariantList& emojis) {
+                // Emojis show up while the full list is still downloading
+                m_emojiCache->loadAllEmojis(emojis);
+            });
     connect(m_apiClient, &ApiClient::allEmojisFetchFailed,
             this, &SerchatAPI::allEmojisFetchFailed);
     
@@ -212,13 +252,33 @@ SerchatAPI::SerchatAPI() {
     connect(m_apiClient, &ApiClient::messagesFetched,
             this, &SerchatAPI::handleMessagesFetched);
     connect(m_apiClient, &ApiClient::messagesFetchFailed,
-            this, &SerchatAPI::messagesFetchFailed);
+            this, [this](int requestId, const QString& serverId, const QString& channelId,
+                         const QString& error) {
+                // Delta sync pages are internal to MessageCache
+                m_messagePageLimits.remove(requestId);
+                if (m_messageCache->isSyncRequest(requestId) || m_newerPageRequests.remove(requestId)) {
+                    return;
+                }
+                m_paginationRequests.remove(requestId);
+                emit messagesFetchFailed(requestId, serverId, channelId, error);
+            });
 
     // Also connect to MessageCache for its internal refresh mechanism
     connect(m_apiClient, &ApiClient::messagesFetched,
             m_messageCache, &MessageCache::onMessagesFetched);
     connect(m_apiClient, &ApiClient::messagesFetchFailed,
             m_messageCache, &MessageCache::onMessagesFetchFailed);
+    connect(m_messageCache, &MessageCache::messagesSynced,
+            this, &SerchatAPI::handleMessagesSynced);
+    connect(m_messageCache, &MessageCache::messagesReset,
+            this, [this](const QString& channelId) {
+                // Only an open channel showing its live end follows the reset;
+                // a scrolled-back window still joins up via loadNewerMessages()
+                if (!m_messageModel->isDMMode() && m_messageModel->channelId() == channelId &&
+                    !m_messageModel->hasNewerMessages()) {
+                    jumpToLatestMessages(m_messageModel->serverId(), channelId);
+                }
+            });
     connect(m_apiClient, &ApiClient::messageSent,
             this, &SerchatAPI::messageSent);
     connect(m_apiClient, &ApiClient::messageSendFailed,
@@ -281,6 +341,20 @@ SerchatAPI::SerchatAPI() {
             this, &SerchatAPI::socketReconnecting);
     connect(m_socketClient, &SocketClient::error,
             this, &SerchatAPI::socketError);
+    connect(m_socketClient, &SocketClient::sendFailed,
+            this, [this](const QString& eventType, const QVariantMap& payload) {
+                // Lets the message views drop their optimistic copy
+                if (eventType == QLatin1String("send_message_server")) {
+                    emit messageSendFailed(0, QStringLiteral("Message could not be delivered"));
+                } else if (eventType == QLatin1String("send_message_dm")) {
+                    emit dmMessageSendFailed(0, QStringLiteral("Message could not be delivered"));
+                }
+                emit socketSendFailed(eventType, payload);
+            });
+    connect(m_socketClient, &SocketClient::batchStarted,
+            this, &SerchatAPI::handleSocketBatchStarted);
+    connect(m_socketClient, &SocketClient::batchFinished,
+            this, &SerchatAPI::handleSocketBatchFinished);
     
     // Real-time server message events - route through internal handlers to update caches
     connect(m_socketClient, &SocketClient::serverMessageReceived,
@@ -471,6 +545,7 @@ void SerchatAPI::setApiBaseUrl(const QString& baseUrl) {
         m_settings->setValue("apiBaseUrl", baseUrl);
         m_authClient->setBaseUrl(baseUrl);
         m_apiClient->setBaseUrl(baseUrl);
+        m_apiClient->clearCache();  // Including the disk copy from the old instance
         m_emojiCache->setBaseUrl(baseUrl);
         m_userProfileCache->setBaseUrl(baseUrl);
         emit apiBaseUrlChanged();
@@ -559,6 +634,9 @@ void SerchatAPI::setViewingDMRecipientId(const QString& id) {
 
 void SerchatAPI::setActiveChannel(const QString& serverId, const QString& channelId) {
     m_messageCache->setActiveChannel(serverId, channelId);
+
+    // Profile/emoji lookups still queued were for the previous view
+    m_apiClient->cancelQueuedBackgroundRequests();
     qDebug() << "[SerchatAPI] Active channel set to:" << serverId << "/" << channelId;
 }
 
@@ -571,6 +649,7 @@ void SerchatAPI::setCurrentServer(const QString& serverId) {
     qDebug() << "[SerchatAPI] Setting current server and preloading data for:" << serverId;
 
     // Clear any previous server's UI-specific data
+    m_apiClient->cancelQueuedBackgroundRequests();
     m_channelListModel->clear();
     m_membersModel->clear();
     m_rolesModel->clear();
@@ -662,7 +741,9 @@ int SerchatAPI::getMyProfile() {
 }
 
 int SerchatAPI::getProfile(const QString& userId, bool useCache) {
-    return m_apiClient->getProfile(userId, useCache);
+    // Asked for by a page or sheet the user opened - never queued behind
+    // (or dropped with) the background profile lookups
+    return m_apiClient->getProfile(userId, useCache, NetworkClient::Priority::Interactive);
 }
 
 int SerchatAPI::updateDisplayName(const QString& displayName) {
@@ -795,7 +876,83 @@ int SerchatAPI::getEmojiById(const QString& emojiId, bool useCache) {
 
 int SerchatAPI::getMessages(const QString& serverId, const QString& channelId,
                             int limit, const QString& before) {
-    return m_apiClient->getMessages(serverId, channelId, limit, before);
+    int requestId = m_apiClient->getMessages(serverId, channelId, limit, before);
+    m_messagePageLimits.insert(requestId, limit);
+    if (!before.isEmpty()) {
+        m_paginationRequests.insert(requestId);
+    } else {
+        // First page means the channel was just opened - keep it resident
+        m_messageCache->noteChannelViewed(channelId);
+    }
+    return requestId;
+}
+
+int SerchatAPI::loadCachedMessages(const QString& serverId, const QString& channelId) {
+    if (serverId.isEmpty() || channelId.isEmpty()) {
+        return 0;
+    }
+
+    // Cache is oldest-first, the model is newest-first (BottomToTop ListView)
+    QVariantList cached = m_messageCache->cachedMessages(channelId);
+    QVariantList reversedMessages;
+    reversedMessages.reserve(cached.size());
+    for (int i = cached.size() - 1; i >= 0; --i) {
+        reversedMessages.append(cached.at(i));
+    }
+
+    m_messageModel->appendMessages(reversedMessages);
+    qDebug() << "[SerchatAPI] Painted" << reversedMessages.size() << "cached messages for channel:" << channelId;
+    return reversedMessages.size();
+}
+
+int SerchatAPI::loadNewerMessages(const QString& serverId, const QString& channelId, int limit) {
+    QString newestId = m_messageModel->newestMessageId();
+    if (serverId.isEmpty() || channelId.isEmpty() || newestId.isEmpty() ||
+        !m_messageModel->hasNewerMessages() || m_messageModel->channelId() != channelId) {
+        return 0;
+    }
+
+    // The cache holds the newest stretch of the channel; use it once the
+    // window has scrolled back into that range
+    bool reachedNewest = false;
+    QVariantList cached = m_messageCache->messagesAfter(channelId, newestId, limit, &reachedNewest);
+    if (!cached.isEmpty() || reachedNewest) {
+        QVariantList reversedMessages;
+        reversedMessages.reserve(cached.size());
+        for (int i = cached.size() - 1; i >= 0; --i) {
+            reversedMessages.append(cached.at(i));
+        }
+        m_messageModel->prependMessages(reversedMessages, !reachedNewest);
+        return 0;
+    }
+
+    // Still older than anything cached - fetch the chunk around the newest
+    // row; its newer half continues the window
+    int requestId = m_apiClient->getMessages(serverId, channelId, limit, QString(), newestId);
+    m_newerPageRequests.insert(requestId, newestId);
+    m_messagePageLimits.insert(requestId, limit);
+    return requestId;
+}
+
+int SerchatAPI::jumpToLatestMessages(const QString& serverId, const QString& channelId) {
+    if (serverId.isEmpty() || channelId.isEmpty()) {
+        return 0;
+    }
+
+    QVariantList cached = m_messageCache->cachedMessages(channelId);
+    if (cached.isEmpty()) {
+        return 0;
+    }
+
+    QVariantList reversedMessages;
+    reversedMessages.reserve(cached.size());
+    for (int i = cached.size() - 1; i >= 0; --i) {
+        reversedMessages.append(cached.at(i));
+    }
+
+    m_messageModel->replaceMessages(reversedMessages);
+    m_messageModel->setHasMoreMessages(true);
+    return reversedMessages.size();
 }
 
 int SerchatAPI::sendMessage(const QString& serverId, const QString& channelId,
@@ -1067,6 +1224,18 @@ QString SerchatAPI::socketId() const {
     return m_socketClient->socketId();
 }
 
+QVariantMap SerchatAPI::socketEventStats() const {
+    return m_socketClient->eventStats();
+}
+
+void SerchatAPI::setSocketEventBatching(bool enabled, int windowMs) {
+    m_socketClient->setBatchWindow(enabled ? qMax(0, windowMs) : -1);
+}
+
+void SerchatAPI::setSocketBinaryTransport(bool enabled) {
+    m_socketClient->setBinaryTransport(enabled);
+}
+
 void SerchatAPI::connectSocket() {
     if (!isLoggedIn()) {
         qWarning() << "[SerchatAPI] Cannot connect socket: not logged in";
@@ -1360,6 +1529,24 @@ void SerchatAPI::handleChannelsFetched(int requestId, const QString& serverId, c
 }
 
 void SerchatAPI::handleMessagesFetched(int requestId, const QString& serverId, const QString& channelId, const QVariantList& messages) {
+    // Delta sync pages are partial - MessageCache merges them itself and
+    // reports the result through messagesSynced
+    if (m_messageCache->isSyncRequest(requestId)) {
+        return;
+    }
+
+    bool fullPage = messages.size() >= m_messagePageLimits.take(requestId);
+
+    // Chunks paged back into a scrolled-back window sit between the model
+    // and the cached live end - they belong to the model only
+    if (m_newerPageRequests.contains(requestId)) {
+        QString anchorId = m_newerPageRequests.take(requestId);
+        if (!m_messageModel->isDMMode() && m_messageModel->channelId() == channelId) {
+            applyNewerPage(serverId, channelId, anchorId, messages);
+        }
+        return;
+    }
+
     // API returns messages oldest-first, but UI needs newest-first (for BottomToTop ListView)
     // Reverse here to centralize this logic and avoid doing it in QML
     QVariantList reversedMessages;
@@ -1372,13 +1559,68 @@ void SerchatAPI::handleMessagesFetched(int requestId, const QString& serverId, c
     // Note: This function handles messages in any order (compares all timestamps)
     calculateFirstUnreadMessage(serverId, channelId, reversedMessages);
 
-    // Update message cache with reversed messages (newest-first order)
-    m_messageCache->loadMessages(serverId, channelId, reversedMessages);
+    // Update message cache with reversed messages (newest-first order).
+    // Older-history pages extend the cached range instead of replacing it.
+    bool isPagination = m_paginationRequests.remove(requestId);
+    m_messageCache->loadMessages(serverId, channelId, reversedMessages, isPagination, fullPage);
 
     // Forward reversed messages to QML (ready for display without further processing)
     emit messagesFetched(requestId, serverId, channelId, reversedMessages);
 }
 
+void SerchatAPI::applyNewerPage(const QString& serverId, const QString& channelId,
+                                const QString& anchorId, const QVariantList& messages) {
+    // Only what follows the model's newest row is contiguous with it. If
+    // the page doesn't contain that row, the gap can't be closed - show the
+    // live end instead of splicing unrelated history together.
+    int anchorIdx = -1;
+    for (int i = 0; i < messages.size(); ++i) {
+        if (messages.at(i).toMap().value("_id").toString() == anchorId) {
+            anchorIdx = i;
+            break;
+        }
+    }
+    if (anchorIdx < 0 || m_messageModel->newestMessageId() != anchorId) {
+        qDebug() << "[SerchatAPI] Newer page doesn't join the window - jumping to latest";
+        if (jumpToLatestMessages(serverId, channelId) == 0) {
+            // Nothing cached to jump to; start over from the latest page
+            m_messageModel->replaceMessages(QVariantList());
+            getMessages(serverId, channelId, 50, QString());
+        }
+        return;
+    }
+
+    // Newest first for the model
+    QVariantList newer;
+    for (int i = messages.size() - 1; i > anchorIdx; --i) {
+        newer.append(messages.at(i));
+    }
+
+    // Nothing after the anchor: the window reached the live end
+    m_messageModel->prependMessages(newer, !newer.isEmpty());
+}
+
+void SerchatAPI::handleMessagesSynced(const QString& channelId, const QVariantList& added,
+                                      const QVariantList& updated, const QStringList& removedIds) {
+    if (m_messageModel->isDMMode() || m_messageModel->channelId() != channelId) {
+        return;
+    }
+
+    // Added messages come oldest first, so prepending keeps newest at row 0
+    for (const QVariant& message : added) {
+        m_messageModel->prependMessage(message.toMap());
+    }
+    for (const QVariant& message : updated) {
+        QVariantMap map = message.toMap();
+        m_messageModel->updateMessage(map.value("_id").toString(), map);
+    }
+    for (const QString& messageId : removedIds) {
+        m_messageModel->deleteMessage(messageId);
+    }
+
+    qDebug() << "[SerchatAPI] Applied delta sync to open channel" << channelId;
+}
+
 void SerchatAPI::handleDMMessagesFetched(int requestId, const QString& recipientId, const QVariantList& messages) {
     // API returns messages oldest-first, but UI needs newest-first (for BottomToTop ListView)
     // Reverse here to centralize this logic and avoid doing it in QML
@@ -1754,6 +1996,14 @@ void SerchatAPI::handleDMUnread(const QString& peer, int count) {
 // ============================================================================
 
 void SerchatAPI::handleSocketConnected() {
+    if (m_socketClient->sessionResumed()) {
+        // The server replays everything missed since the last applied
+        // event, so the caches stay valid
+        qDebug() << "[SerchatAPI] Socket session resumed - skipping cache refresh";
+        emit socketConnected();
+        return;
+    }
+    
     qDebug() << "[SerchatAPI] Socket connected - marking caches as stale for refresh";
     
     // Mark all caches as stale so they'll refresh on next access
@@ -1762,13 +2012,33 @@ void SerchatAPI::handleSocketConnected() {
     m_channelCache->markAllStale();
     m_messageCache->markAllStale();
     
-    // Refresh the active channel immediately for fluid UX
+    // Catch the active channel up immediately for fluid UX (delta sync:
+    // only messages missed while disconnected are fetched)
     m_messageCache->refreshActiveChannel();
     
     // Forward signal to QML
     emit socketConnected();
 }
 
+void SerchatAPI::handleSocketBatchStarted() {
+    // Everything the batch touches signals once, in handleSocketBatchFinished()
+    m_emojiCache->beginBatch();
+    m_userProfileCache->beginBatch();
+    m_serverMemberCache->beginBatch();
+    m_channelCache->beginBatch();
+    m_messageCache->beginBatch();
+    m_messageModel->beginBatch();
+}
+
+void SerchatAPI::handleSocketBatchFinished() {
+    m_messageModel->endBatch();
+    m_messageCache->endBatch();
+    m_channelCache->endBatch();
+    m_serverMemberCache->endBatch();
+    m_userProfileCache->endBatch();
+    m_emojiCache->endBatch();
+}
+
 void SerchatAPI::handleSocketDisconnected() {
     qDebug() << "[SerchatAPI] Socket disconnected";
 
@@ -1822,11 +2092,19 @@ void SerchatAPI::handleApplicationStateChanged(Qt::ApplicationState state) {
     if (state == Qt::ApplicationActive) {
         // App resumed - check if socket needs reconnection
         // Cache refresh is handled by handleSocketConnected() when socket reconnects
-        if (isLoggedIn() && hasValidAuthToken() && !isSocketConnected()) {
-            qDebug() << "[SerchatAPI] App activated - socket disconnected, reconnecting...";
-            m_socketClient->resetReconnectAttempts();
-            connectSocket();
+        if (isLoggedIn() && hasValidAuthToken()) {
+            if (isSocketConnected()) {
+                // Connections often die silently while suspended
+                m_socketClient->checkConnectionHealth();
+            } else if (!m_socketClient->reconnectNow()) {
+                qDebug() << "[SerchatAPI] App activated - socket disconnected, reconnecting...";
+                connectSocket();
+            }
         }
+    } else if (state == Qt::ApplicationSuspended || state == Qt::ApplicationInactive) {
+        // The process may be killed while in the background - get pending
+        // message snapshots onto disk now
+        m_messageCache->flush();
     }
 }
 
@@ -6,6 +6,7 @@
 #include <QVariantList>
 #include <QVariantMap>
 #include <QMap>
+#include <QHash>
 #include <QSet>
 #include <QSettings>
 #include <QTimer>
@@ -486,6 +487,36 @@ public:
     Q_INVOKABLE int getMessages(const QString& serverId, const QString& channelId,
                                 int limit = 50, const QString& before = QString());
     
+    /**
+     * @brief Fill the message model from the message cache (memory or disk).
+     * Lets a channel paint immediately while getMessages() is in flight.
+     * @param serverId The server ID
+     * @param channelId The channel ID
+     * @return Number of messages placed in the model (0 if nothing cached)
+     */
+    Q_INVOKABLE int loadCachedMessages(const QString& serverId, const QString& channelId);
+    
+    /**
+     * @brief Page newer messages back into a windowed message model.
+     * After scrolling far back, the model drops its newest rows
+     * (messageModel.hasNewerMessages). This refills the next chunk above
+     * messageModel.newestMessageId(), from the message cache when it covers
+     * that range and otherwise from an API page around the newest row. If
+     * that page can't be joined to the model, the model jumps to the live end.
+     * @param serverId The server ID
+     * @param channelId The channel ID
+     * @param limit Maximum number of messages to page in
+     * @return Request ID if a fetch was started, 0 if served from the cache
+     */
+    Q_INVOKABLE int loadNewerMessages(const QString& serverId, const QString& channelId, int limit = 50);
+    
+    /**
+     * @brief Snap a scrolled-back message model to the live end of the channel.
+     * Refills the model from the message cache (e.g. before sending).
+     * @return Number of messages placed in the model (0 if nothing cached)
+     */
+    Q_INVOKABLE int jumpToLatestMessages(const QString& serverId, const QString& channelId);
+    
     /**
      * @brief Send a message to a channel.
      * @param serverId The server ID
@@ -558,6 +589,19 @@ public:
     /// Get socket ID
     Q_INVOKABLE QString socketId() const;
     
+    /// Per-event-type socket dispatch counts and handler timings (see SocketClient::eventStats)
+    Q_INVOKABLE QVariantMap socketEventStats() const;
+    
+    /// Apply socket events in batches: everything arriving within windowMs
+    /// (0 = one event loop pass) yields one versionChanged per cache and
+    /// coalesced message model updates. Off by default.
+    Q_INVOKABLE void setSocketEventBatching(bool enabled, int windowMs = 0);
+    
+    /// Ask the socket server for CBOR binary frames instead of JSON text
+    /// (smaller on metered data). Applies from the next connect; JSON is
+    /// kept if the server doesn't support it.
+    Q_INVOKABLE void setSocketBinaryTransport(bool enabled);
+    
     /// Get unread state version (for QML binding updates)
     int unreadStateVersion() const { return m_unreadStateVersion; }
     
@@ -795,6 +839,10 @@ signals:
     void socketDisconnected();
     void socketReconnecting(int attempt);
     void socketError(const QString& message);
+    /// A queued socket event was given up on (never acked or queue overflow).
+    /// Failed message sends are also reported via messageSendFailed /
+    /// dmMessageSendFailed with requestId 0.
+    void socketSendFailed(const QString& eventType, const QVariantMap& payload);
     
     // Unread state version changed signal (for QML binding triggers)
     void unreadStateVersionChanged();
@@ -1004,6 +1052,8 @@ private slots:
     // Socket connection handlers (for cache refresh)
     void handleSocketConnected();
     void handleSocketDisconnected();
+    void handleSocketBatchStarted();
+    void handleSocketBatchFinished();
     
     // Socket event handlers for cache updates
     void handleServerMessageReceived(const QVariantMap& message);
@@ -1067,6 +1117,17 @@ private:
     // Markdown parser (owned by this class, exposed to QML)
     MarkdownParser* m_markdownParser;
     
+    // Request IDs of getMessages() calls that load older history
+    QSet<int> m_paginationRequests;
+    
+    // Requested page size per getMessages()/loadNewerMessages() request,
+    // to tell a full page (more to load) from the end of history
+    QHash<int, int> m_messagePageLimits;
+    
+    // loadNewerMessages() fetches (go to the model only): requestId -> the
+    // model's newest message ID the page has to join up with
+    QHash<int, QString> m_newerPageRequests;
+    
     // Presence tracking
     QSet<QString> m_onlineUsers;
     
@@ -1142,6 +1203,14 @@ private:
 
     // DM messages data handler - reverses order for UI
     void handleDMMessagesFetched(int requestId, const QString& recipientId, const QVariantList& messages);
+
+    // loadNewerMessages() page - joins it to the model's newest row or jumps to the live end
+    void applyNewerPage(const QString& serverId, const QString& channelId,
+                        const QString& anchorId, const QVariantList& messages);
+
+    // Delta sync result - applies missed messages/edits/deletes to the open channel
+    void handleMessagesSynced(const QString& channelId, const QVariantList& added,
+                              const QVariantList& updated, const QStringList& removedIds);
 };
 
 #endif
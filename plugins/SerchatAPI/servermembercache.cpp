@@ -18,6 +18,8 @@ void ServerMemberCache::setApiClient(ApiClient* apiClient)
     if (m_apiClient) {
         connect(m_apiClient, &ApiClient::serverMembersFetched,
                 this, &ServerMemberCache::onServerMembersFetched);
+        connect(m_apiClient, &ApiClient::serverMembersBatchFetched,
+                this, &ServerMemberCache::onServerMembersBatchFetched);
         connect(m_apiClient, &ApiClient::serverMembersFetchFailed,
                 this, &ServerMemberCache::onServerMembersFetchFailed);
         connect(m_apiClient, &ApiClient::serverRolesFetched,
@@ -308,6 +310,24 @@ void ServerMemberCache::updateServerMembers(const QString& serverId, const QVari
     }
     
     // Insert new members
+    insertMembers(serverId, members);
+    
+    m_fetchingMembers.remove(serverId);
+    bumpVersion();
+}
+
+void ServerMemberCache::addServerMembers(const QString& serverId, const QVariantList& members)
+{
+    if (serverId.isEmpty() || members.isEmpty()) {
+        return;
+    }
+    
+    insertMembers(serverId, members);
+    bumpVersion();
+}
+
+void ServerMemberCache::insertMembers(const QString& serverId, const QVariantList& members)
+{
     for (const QVariant& memberVar : members) {
         QVariantMap member = memberVar.toMap();
         QString userId = extractUserId(member);
@@ -319,9 +339,6 @@ void ServerMemberCache::updateServerMembers(const QString& serverId, const QVari
         QString key = memberKey(serverId, userId);
         m_members.insert(key, member);
     }
-    
-    m_fetchingMembers.remove(serverId);
-    bumpVersion();
 }
 
 void ServerMemberCache::updateServerRoles(const QString& serverId, const QVariantList& roles)
@@ -419,6 +436,13 @@ void ServerMemberCache::onServerMembersFetched(int requestId, const QString& ser
     updateServerMembers(serverId, members);
 }
 
+void ServerMemberCache::onServerMembersBatchFetched(int requestId, const QString& serverId, const QVariantList& members)
+{
+    Q_UNUSED(requestId)
+    // Lets lookups succeed before a large member list has finished downloading
+    addServerMembers(serverId, members);
+}
+
 void ServerMemberCache::onServerMembersFetchFailed(int requestId, const QString& serverId, const QString& error)
 {
     m_pendingMemberFetches.remove(requestId);
@@ -447,12 +471,6 @@ void ServerMemberCache::onServerRolesFetchFailed(int requestId, const QString& s
 // Private helpers
 // ============================================================================
 
-void ServerMemberCache::bumpVersion()
-{
-    m_version++;
-    emit versionChanged();
-}
-
 QString ServerMemberCache::memberKey(const QString& serverId, const QString& userId)
 {
     return serverId + ":" + userId;
@@ -8,6 +8,8 @@
 #include <QVariantList>
 #include <QString>
 
+#include "versionbatcher.h"
+
 class ApiClient;
 
 /**
@@ -152,7 +154,11 @@ public:
     /**
      * @brief Get version counter for QML binding invalidation.
      */
-    int version() const { return m_version; }
+    int version() const { return m_versions.version(); }
+    
+    /// Coalesce versionChanged() until endBatch() (see VersionBatcher)
+    void beginBatch() { m_versions.begin(); }
+    void endBatch() { if (m_versions.end()) emit versionChanged(); }
     
     // ========================================================================
     // C++ methods for cache management
@@ -171,6 +177,13 @@ public:
      */
     void updateServerMembers(const QString& serverId, const QVariantList& members);
     
+    /**
+     * @brief Add members without dropping the server's existing ones.
+     * Called for each batch of a member list that is still downloading;
+     * updateServerMembers() replaces the set once it is complete.
+     */
+    void addServerMembers(const QString& serverId, const QVariantList& members);
+    
     /**
      * @brief Update roles for a server.
      * Called when server roles are fetched.
@@ -224,6 +237,11 @@ private slots:
      */
     void onServerMembersFetched(int requestId, const QString& serverId, const QVariantList& members);
     
+    /**
+     * @brief Handle a batch of a server members list still downloading.
+     */
+    void onServerMembersBatchFetched(int requestId, const QString& serverId, const QVariantList& members);
+    
     /**
      * @brief Handle failed server members fetch.
      */
@@ -262,12 +280,17 @@ private:
     ApiClient* m_apiClient = nullptr;
     
     // Version counter for QML
-    int m_version = 0;
+    VersionBatcher m_versions;
     
     /**
      * @brief Increment version and emit signal.
      */
-    void bumpVersion();
+    void bumpVersion() { if (m_versions.bump()) emit versionChanged(); }
+    
+    /**
+     * @brief Store members under a server (no clearing, no version bump).
+     */
+    void insertMembers(const QString& serverId, const QVariantList& members);
     
     /**
      * @brief Generate composite key for member lookup.
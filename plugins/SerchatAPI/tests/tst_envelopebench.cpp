@@ -0,0 +1,90 @@
+#include <QtTest>
+#include <QUuid>
+
+#include "network/jsonwriter.h"
+
+/**
+ * @brief Cost of building an outbound socket envelope.
+ *
+ * Builds the most frequent outbound frame the way SocketClient::sendTyping()
+ * does, through the same writeEnvelope() as encodeEnvelope(), minus the
+ * socket write. Envelope IDs come
+ * from a local counter shaped like SocketClient::generateMessageId() so
+ * no client state is touched.
+ */
+class TestEnvelopeBench : public QObject {
+    Q_OBJECT
+
+private:
+    QString m_idPrefix = QStringLiteral("k3j9x2m1q8-");
+    quint64 m_idCounter = 0;
+    const QString m_serverId = QStringLiteral("5f1c0a2b3d4e5f6a7b8c9d0e");
+    const QString m_channelId = QStringLiteral("5f1c0a2b3d4e5f6a7b8c9d0f");
+
+    QString nextId()
+    {
+        return m_idPrefix + QString::number(++m_idCounter, 36);
+    }
+
+    QByteArray typingPayload() const
+    {
+        JsonWriter payload;
+        payload.beginObject();
+        payload.field("serverId", m_serverId);
+        payload.field("channelId", m_channelId);
+        payload.endObject();
+        return payload.data();
+    }
+
+    void writeTyping(JsonWriter& w)
+    {
+        writeEnvelope(w, QStringLiteral("typing_server"), typingPayload(), QString(),
+                      nextId(), QDateTime::currentMSecsSinceEpoch());
+    }
+
+private slots:
+    void envelopeIsValidJson()
+    {
+        JsonWriter w;
+        writeTyping(w);
+
+        QJsonParseError error;
+        QJsonObject envelope = QJsonDocument::fromJson(w.data(), &error).object();
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        QCOMPARE(envelope["event"].toObject()["type"].toString(), QStringLiteral("typing_server"));
+        QCOMPARE(envelope["event"].toObject()["payload"].toObject()["channelId"].toString(), m_channelId);
+    }
+
+    void uuidId()
+    {
+        int length = 0;
+        QBENCHMARK {
+            length += QUuid::createUuid().toString(QUuid::WithoutBraces).size();
+        }
+        QVERIFY(length > 0);
+    }
+
+    void counterId()
+    {
+        int length = 0;
+        QBENCHMARK {
+            length += nextId().size();
+        }
+        QVERIFY(length > 0);
+    }
+
+    void typingEnvelope()
+    {
+        // A long-lived writer, as SocketClient keeps m_frameWriter
+        JsonWriter w;
+        int length = 0;
+        QBENCHMARK {
+            writeTyping(w);
+            length += QString::fromUtf8(w.data()).size();
+        }
+        QVERIFY(length > 0);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestEnvelopeBench)
+#include "tst_envelopebench.moc"
@@ -0,0 +1,165 @@
+#include <QtTest>
+
+#include "network/jsonarraystream.h"
+
+/**
+ * @brief JsonArrayStream splitting with chunks cut at every possible byte.
+ */
+class TestJsonArrayStream : public QObject {
+    Q_OBJECT
+
+private:
+    // Strings hiding commas, brackets and escaped quotes/backslashes, plus
+    // nesting, so that a cut anywhere lands inside each of them once
+    static QByteArray body()
+    {
+        return QByteArray(R"json( [{"a":"x,y]"},"q\"]\\",[1,[2,{"c":[]}]],{"b":"\\\\"},"]" , 42 ,
+null] )json");
+    }
+
+    static QByteArrayList expectedElements()
+    {
+        return QByteArrayList()
+            << R"json({"a":"x,y]"})json"
+            << R"json("q\"]\\")json"
+            << R"json([1,[2,{"c":[]}]])json"
+            << R"json({"b":"\\\\"})json"
+            << R"json("]")json"
+            << "42"
+            << "null";
+    }
+
+private slots:
+    void wholeBody()
+    {
+        JsonArrayStream stream;
+        QByteArrayList elements;
+        stream.feed(body(), elements);
+
+        QCOMPARE(elements, expectedElements());
+        QCOMPARE(stream.state(), JsonArrayStream::Done);
+    }
+
+    void splitInTwo()
+    {
+        const QByteArray json = body();
+        for (int cut = 0; cut <= json.size(); ++cut) {
+            JsonArrayStream stream;
+            QByteArrayList elements;
+            stream.feed(json.left(cut), elements);
+            stream.feed(json.mid(cut), elements);
+
+            QVERIFY2(elements == expectedElements(), qPrintable(QString("cut at %1").arg(cut)));
+            QCOMPARE(stream.state(), JsonArrayStream::Done);
+        }
+    }
+
+    void splitInThree()
+    {
+        const QByteArray json = body();
+        for (int first = 0; first <= json.size(); ++first) {
+            for (int second = first; second <= json.size(); ++second) {
+                JsonArrayStream stream;
+                QByteArrayList elements;
+                stream.feed(json.left(first), elements);
+                stream.feed(json.mid(first, second - first), elements);
+                stream.feed(json.mid(second), elements);
+
+                QVERIFY2(elements == expectedElements(),
+                         qPrintable(QString("cuts at %1 and %2").arg(first).arg(second)));
+            }
+        }
+    }
+
+    void byteByByte()
+    {
+        const QByteArray json = body();
+        JsonArrayStream stream;
+        QByteArrayList elements;
+        for (int i = 0; i < json.size(); ++i) {
+            stream.feed(json.mid(i, 1), elements);
+        }
+
+        QCOMPARE(elements, expectedElements());
+        QCOMPARE(stream.state(), JsonArrayStream::Done);
+    }
+
+    void elementsAreHandedOutAsTheyComplete()
+    {
+        JsonArrayStream stream;
+        QByteArrayList elements;
+
+        stream.feed(R"json([{"a":"x,)json", elements);
+        QVERIFY(elements.isEmpty());
+        QCOMPARE(stream.state(), JsonArrayStream::InArray);
+
+        stream.feed(R"json(y"}, 2)json", elements);
+        QCOMPARE(elements, QByteArrayList() << R"json({"a":"x,y"})json");
+
+        // A number isn't complete until its separator shows up
+        stream.feed(",", elements);
+        QCOMPARE(elements.size(), 2);
+        QCOMPARE(elements.last(), QByteArray("2"));
+    }
+
+    void parsedElementsMatchTheWholeDocument()
+    {
+        JsonArrayStream stream;
+        QByteArrayList elements;
+        stream.feed(body(), elements);
+
+        bool ok = false;
+        QVariantList items = JsonArrayStream::parseElements(elements, &ok);
+        QVERIFY(ok);
+        QCOMPARE(items, QJsonDocument::fromJson(body()).array().toVariantList());
+        QCOMPARE(items.at(1).toString(), QStringLiteral("q\"]\\"));
+        QCOMPARE(items.at(4).toString(), QStringLiteral("]"));
+    }
+
+    void emptyArray()
+    {
+        JsonArrayStream stream;
+        QByteArrayList elements;
+        stream.feed("  ", elements);
+        QCOMPARE(stream.state(), JsonArrayStream::Start);
+        stream.feed("[ \n", elements);
+        stream.feed("]", elements);
+
+        QVERIFY(elements.isEmpty());
+        QCOMPARE(stream.state(), JsonArrayStream::Done);
+    }
+
+    void trailingBytesAreIgnored()
+    {
+        JsonArrayStream stream;
+        QByteArrayList elements;
+        stream.feed("[1]", elements);
+        stream.feed(",[2]", elements);
+
+        QCOMPARE(elements, QByteArrayList() << "1");
+        QCOMPARE(stream.state(), JsonArrayStream::Done);
+    }
+
+    void nonArrayBodyFails()
+    {
+        JsonArrayStream stream;
+        QByteArrayList elements;
+        stream.feed(" {\"error\":", elements);
+        stream.feed("\"nope\"}", elements);
+
+        QVERIFY(elements.isEmpty());
+        QCOMPARE(stream.state(), JsonArrayStream::Failed);
+    }
+
+    void malformedElementFailsTheBatch()
+    {
+        bool ok = true;
+        QVariantList items = JsonArrayStream::parseElements(
+            QByteArrayList() << "1" << "{\"a\":}", &ok);
+        QVERIFY(!ok);
+        QVERIFY(items.isEmpty());
+    }
+};
+
+QTEST_APPLESS_MAIN(TestJsonArrayStream)
+#include "tst_jsonarraystream.moc"
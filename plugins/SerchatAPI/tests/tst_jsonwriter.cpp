@@ -0,0 +1,207 @@
+#include <QtTest>
+#include <initializer_list>
+
+#include "network/jsonwriter.h"
+
+/**
+ * @brief JsonWriter string escaping, UTF-8 output and separator placement.
+ */
+class TestJsonWriter : public QObject {
+    Q_OBJECT
+
+private:
+    static QString utf16(std::initializer_list<ushort> units)
+    {
+        QString text;
+        for (ushort unit : units) {
+            text.append(QChar(unit));
+        }
+        return text;
+    }
+
+    static QByteArray encoded(const QString& text)
+    {
+        JsonWriter w;
+        w.value(text);
+        return w.data();
+    }
+
+private slots:
+    void escapes_data()
+    {
+        QTest::addColumn<QString>("text");
+        QTest::addColumn<QByteArray>("expected");
+
+        QTest::newRow("plain") << QStringLiteral("abc") << QByteArray("\"abc\"");
+        QTest::newRow("empty") << QString() << QByteArray("\"\"");
+        QTest::newRow("quote") << QStringLiteral("a\"b") << QByteArray("\"a\\\"b\"");
+        QTest::newRow("backslash") << QStringLiteral("a\\b") << QByteArray("\"a\\\\b\"");
+        QTest::newRow("short escapes") << QStringLiteral("\n\t\r\b\f")
+                                       << QByteArray("\"\\n\\t\\r\\b\\f\"");
+        QTest::newRow("nul") << utf16({0x00}) << QByteArray("\"\\u0000\"");
+        QTest::newRow("control") << utf16({0x01, 0x1f}) << QByteArray("\"\\u0001\\u001f\"");
+        QTest::newRow("delete is not escaped") << utf16({0x7f}) << QByteArray("\"\x7f\"");
+        QTest::newRow("slash is not escaped") << QStringLiteral("a/b") << QByteArray("\"a/b\"");
+    }
+
+    void escapes()
+    {
+        QFETCH(QString, text);
+        QFETCH(QByteArray, expected);
+
+        QCOMPARE(encoded(text), expected);
+
+        // Whatever is written must read back as the same string
+        QJsonDocument doc = QJsonDocument::fromJson("[" + expected + "]");
+        QCOMPARE(doc.array().at(0).toString(), text);
+    }
+
+    void utf8_data()
+    {
+        QTest::addColumn<QString>("text");
+        QTest::addColumn<QByteArray>("expected");
+
+        QTest::newRow("two bytes") << utf16({0x00e9}) << QByteArray("\"\xc3\xa9\"");
+        QTest::newRow("three bytes") << utf16({0x20ac}) << QByteArray("\"\xe2\x82\xac\"");
+        QTest::newRow("surrogate pair") << utf16({0xd83d, 0xde00})
+                                        << QByteArray("\"\xf0\x9f\x98\x80\"");
+        QTest::newRow("highest code point") << utf16({0xdbff, 0xdfff})
+                                            << QByteArray("\"\xf4\x8f\xbf\xbf\"");
+        QTest::newRow("pair between ascii") << utf16({'a', 0xd83d, 0xde00, 'b'})
+                                            << QByteArray("\"a\xf0\x9f\x98\x80" "b\"");
+    }
+
+    void utf8()
+    {
+        QFETCH(QString, text);
+        QFETCH(QByteArray, expected);
+
+        QCOMPARE(encoded(text), expected);
+        QCOMPARE(QJsonDocument::fromJson("[" + expected + "]").array().at(0).toString(), text);
+    }
+
+    void unpairedSurrogates_data()
+    {
+        QTest::addColumn<QString>("text");
+        QTest::addColumn<QByteArray>("expected");
+
+        // Each unpaired half becomes U+FFFD; the rest of the string survives
+        QTest::newRow("high then ascii") << utf16({0xd83d, 'a'})
+                                         << QByteArray("\"\xef\xbf\xbd" "a\"");
+        QTest::newRow("high at end") << utf16({'x', 0xd83d})
+                                     << QByteArray("\"x\xef\xbf\xbd\"");
+        QTest::newRow("lone low") << utf16({0xde00}) << QByteArray("\"\xef\xbf\xbd\"");
+        QTest::newRow("reversed pair") << utf16({0xde00, 0xd83d})
+                                       << QByteArray("\"\xef\xbf\xbd\xef\xbf\xbd\"");
+        QTest::newRow("high before pair") << utf16({0xd83d, 0xd83d, 0xde00})
+                                          << QByteArray("\"\xef\xbf\xbd\xf0\x9f\x98\x80\"");
+    }
+
+    void unpairedSurrogates()
+    {
+        QFETCH(QString, text);
+        QFETCH(QByteArray, expected);
+
+        QCOMPARE(encoded(text), expected);
+    }
+
+    void keysAreEscaped()
+    {
+        JsonWriter w;
+        w.beginObject();
+        w.key(QStringLiteral("a\"b\n"));
+        w.value(1);
+        w.endObject();
+        QCOMPARE(w.data(), QByteArray("{\"a\\\"b\\n\":1}"));
+    }
+
+    void nestingSeparators()
+    {
+        JsonWriter w;
+        w.beginObject();
+        w.field("a", 1);
+        w.key("b");
+        w.beginArray();
+        w.value(1);
+        w.beginObject();
+        w.endObject();
+        w.beginArray();
+        w.endArray();
+        w.value("x");
+        w.endArray();
+        w.field("c", true);
+        w.key("d");
+        w.beginObject();
+        w.field("e", QVariant());
+        w.endObject();
+        w.endObject();
+
+        QCOMPARE(w.data(), QByteArray("{\"a\":1,\"b\":[1,{},[],\"x\"],\"c\":true,\"d\":{\"e\":null}}"));
+        QVERIFY(!QJsonDocument::fromJson(w.data()).isNull());
+    }
+
+    void rawValuesTakeSeparators()
+    {
+        JsonWriter w;
+        w.beginArray();
+        w.raw("{}");
+        w.raw("[1]");
+        w.null();
+        w.endArray();
+        QCOMPARE(w.data(), QByteArray("[{},[1],null]"));
+    }
+
+    void variants()
+    {
+        QVariantMap inner;
+        inner.insert(QStringLiteral("list"), QVariantList() << 1 << QStringLiteral("two") << QVariantMap());
+        inner.insert(QStringLiteral("tags"), QStringList() << QStringLiteral("x") << QStringLiteral("y"));
+
+        JsonWriter w;
+        w.value(QVariant(inner));
+        QCOMPARE(w.data(), QByteArray("{\"list\":[1,\"two\",{}],\"tags\":[\"x\",\"y\"]}"));
+    }
+
+    void numbers()
+    {
+        JsonWriter w;
+        w.beginArray();
+        w.value(-42);
+        w.value(Q_INT64_C(9007199254740993));
+        w.value(0.1);
+        w.value(qInf());
+        w.value(qQNaN());
+        w.endArray();
+        QCOMPARE(w.data(), QByteArray("[-42,9007199254740993,0.1,null,null]"));
+    }
+
+    void resetStartsOver()
+    {
+        JsonWriter w;
+        w.beginObject();
+        w.field("a", 1);
+        w.endObject();
+        QCOMPARE(w.data(), QByteArray("{\"a\":1}"));
+
+        // No separator carried over from the previous document
+        w.reset();
+        w.beginArray();
+        w.value(true);
+        w.endArray();
+        QCOMPARE(w.data(), QByteArray("[true]"));
+
+        // Nor the pending-key state of an abandoned one
+        w.reset();
+        w.beginObject();
+        w.key("x");
+        w.reset();
+        w.beginArray();
+        w.value(1);
+        w.value(2);
+        w.endArray();
+        QCOMPARE(w.data(), QByteArray("[1,2]"));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestJsonWriter)
+#include "tst_jsonwriter.moc"
@@ -0,0 +1,126 @@
+#include <QtTest>
+#include <QNetworkAccessManager>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "api/apiclient.h"
+#include "network/networkclient.h"
+
+namespace {
+const int kMembers = 2000;
+}
+
+/**
+ * @brief Cancelling a streamed member list once it has downloaded but
+ * while batches are still on the parse workers.
+ *
+ * A local HTTP server answers with a member list large enough to be split
+ * into several batches. Two requests share the download; the one owning
+ * it is cancelled as soon as the reply has finished, and the other must
+ * still get the whole list.
+ */
+class TestListStreamCancel : public QObject {
+    Q_OBJECT
+
+private:
+    static QByteArray memberList()
+    {
+        QByteArray json = "[";
+        for (int i = 0; i < kMembers; ++i) {
+            if (i > 0) {
+                json += ',';
+            }
+            json += QStringLiteral("{\"_id\":\"m%1\",\"username\":\"user %1\",\"roles\":[\"a\",\"b\"]}")
+                        .arg(i).toUtf8();
+        }
+        json += "]";
+        return json;
+    }
+
+    static void serve(QTcpServer* server, const QByteArray& body)
+    {
+        QObject::connect(server, &QTcpServer::newConnection, server, [server, body]() {
+            QTcpSocket* socket = server->nextPendingConnection();
+            QSharedPointer<QByteArray> request(new QByteArray);
+            QObject::connect(socket, &QTcpSocket::readyRead, socket, [socket, body, request]() {
+                request->append(socket->readAll());
+                if (!request->contains("\r\n\r\n")) {
+                    return;
+                }
+                request->clear();
+                socket->write("HTTP/1.1 200 OK\r\n"
+                              "Content-Type: application/json\r\n"
+                              "Connection: close\r\n"
+                              "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n");
+                socket->write(body);
+                socket->disconnectFromHost();
+            });
+            QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        });
+    }
+
+private slots:
+    void cancelOwnerWhileParsing()
+    {
+        QTcpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+        serve(&server, memberList());
+
+        NetworkClient network;
+        ApiClient api(&network);
+        api.setBaseUrl(QStringLiteral("http://127.0.0.1:%1").arg(server.serverPort()));
+
+        QSignalSpy fetched(&api, &ApiClient::serverMembersFetched);
+        QSignalSpy failed(&api, &ApiClient::serverMembersFetchFailed);
+
+        int owner = api.getServerMembers(QStringLiteral("s1"), false);
+        int waiter = api.getServerMembers(QStringLiteral("s1"), false);
+        QVERIFY(owner != waiter);
+
+        // The manager reports a reply finished after the reply itself, i.e.
+        // after ApiClient has handed the rest of the body to the workers
+        QNetworkAccessManager* manager = network.findChild<QNetworkAccessManager*>();
+        QVERIFY(manager);
+        bool cancelled = false;
+        connect(manager, &QNetworkAccessManager::finished, this, [&](QNetworkReply*) {
+            api.cancelRequest(owner);
+            cancelled = true;
+        });
+
+        QTRY_COMPARE_WITH_TIMEOUT(fetched.count() + failed.count(), 1, 10000);
+        QVERIFY(cancelled);
+        QCOMPARE(failed.count(), 0);
+        QCOMPARE(fetched.at(0).at(0).toInt(), waiter);
+        QCOMPARE(fetched.at(0).at(2).toList().size(), kMembers);
+        QVERIFY(!api.isRequestPending(owner));
+        QVERIFY(!api.isRequestPending(waiter));
+    }
+
+    void destroyWhileParsing()
+    {
+        QTcpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+        serve(&server, memberList());
+
+        NetworkClient network;
+        QScopedPointer<ApiClient> api(new ApiClient(&network));
+        api->setBaseUrl(QStringLiteral("http://127.0.0.1:%1").arg(server.serverPort()));
+        api->getServerMembers(QStringLiteral("s1"), false);
+
+        // ~ApiClient cancels everything still pending, including a request
+        // whose finished reply is awaiting deletion
+        QNetworkAccessManager* manager = network.findChild<QNetworkAccessManager*>();
+        QVERIFY(manager);
+        bool destroyed = false;
+        connect(manager, &QNetworkAccessManager::finished, this, [&](QNetworkReply*) {
+            api.reset();
+            destroyed = true;
+        });
+
+        QTRY_VERIFY_WITH_TIMEOUT(destroyed, 10000);
+        QTest::qWait(50);  // Let deferred deletes run
+    }
+};
+
+QTEST_GUILESS_MAIN(TestListStreamCancel)
+#include "tst_liststreamcancel.moc"
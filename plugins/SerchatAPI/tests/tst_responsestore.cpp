@@ -0,0 +1,78 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "responsestore.h"
+
+/**
+ * @brief ResponseStore round trips and in-place timestamp updates.
+ */
+class TestResponseStore : public QObject {
+    Q_OBJECT
+
+private:
+    static ResponseStore::Entry entry(const QDateTime& storedAt)
+    {
+        ResponseStore::Entry e;
+        e.data.insert(QStringLiteral("name"), QStringLiteral("general"));
+        e.data.insert(QStringLiteral("ids"), QVariantList() << 1 << 2 << 3);
+        e.storedAt = storedAt;
+        e.etag = "\"abc\"";
+        e.lastModified = "Tue, 13 Oct 2026 10:00:00 GMT";
+        return e;
+    }
+
+private slots:
+    void touchKeepsTheBody()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        ResponseStore store;
+        store.setDirectory(dir.path());
+
+        QDateTime saved = QDateTime::currentDateTimeUtc().addSecs(-3600);
+        QVERIFY(store.save(QStringLiteral("channels:s1"), entry(saved)));
+
+        // Written from local time; stored and read back as UTC
+        QDateTime touched = QDateTime::currentDateTime().addSecs(-5);
+        QVERIFY(store.touch(QStringLiteral("channels:s1"), touched));
+
+        ResponseStore::Entry loaded;
+        QVERIFY(store.load(QStringLiteral("channels:s1"), loaded));
+        QCOMPARE(loaded.storedAt, touched.toUTC());
+        QCOMPARE(loaded.data, entry(saved).data);
+        QCOMPARE(loaded.etag, entry(saved).etag);
+        QCOMPARE(loaded.lastModified, entry(saved).lastModified);
+    }
+
+    void touchRevivesAnOldEntry()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        ResponseStore store;
+        store.setDirectory(dir.path());
+        store.setLimits(1024 * 1024, 60);
+
+        QVERIFY(store.save(QStringLiteral("servers:"),
+                           entry(QDateTime::currentDateTimeUtc().addSecs(-30))));
+        QVERIFY(store.touch(QStringLiteral("servers:"), QDateTime::currentDateTimeUtc()));
+
+        // Too old going by the original write, fresh going by the touch
+        store.setLimits(1024 * 1024, 20);
+        ResponseStore::Entry loaded;
+        QVERIFY(store.load(QStringLiteral("servers:"), loaded));
+    }
+
+    void touchNeedsAnEntry()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        ResponseStore store;
+        store.setDirectory(dir.path());
+
+        QVERIFY(!store.touch(QStringLiteral("roles:s1"), QDateTime::currentDateTimeUtc()));
+        QVERIFY(QDir(dir.path()).entryList(QDir::Files).isEmpty());
+    }
+};
+
+QTEST_APPLESS_MAIN(TestResponseStore)
+#include "tst_responsestore.moc"
@@ -0,0 +1,168 @@
+#include <QtTest>
+#include <QStringList>
+#include <functional>
+
+#include "models/rowindex.h"
+
+/**
+ * @brief RowIndex against a plain QStringList standing in for model rows.
+ */
+class TestRowIndex : public QObject {
+    Q_OBJECT
+
+private:
+    QStringList m_rows;
+    RowIndex m_index;
+
+    std::function<QString(int)> idAt() const
+    {
+        const QStringList& rows = m_rows;
+        return [&rows](int row) { return rows.at(row); };
+    }
+
+    void rebuild(const QStringList& rows)
+    {
+        m_rows = rows;
+        m_index.rebuild(m_rows.size(), idAt());
+    }
+
+    void insert(int row, const QStringList& ids)
+    {
+        for (int i = 0; i < ids.size(); ++i)
+            m_rows.insert(row + i, ids.at(i));
+        m_index.rowsInserted(row, ids.size(), m_rows.size(), idAt());
+    }
+
+    void remove(int row, int count)
+    {
+        for (int i = 0; i < count; ++i)
+            m_index.remove(m_rows.takeAt(row));
+        m_index.rowsRemoved(row, count, m_rows.size(), idAt());
+    }
+
+    // Every row resolves to itself and nothing else is indexed
+    void verifyConsistent()
+    {
+        for (int i = 0; i < m_rows.size(); ++i) {
+            if (!m_rows.at(i).isEmpty())
+                QCOMPARE(m_index.rowOf(m_rows.at(i)), i);
+        }
+        QCOMPARE(m_index.rowOf(QStringLiteral("missing")), -1);
+    }
+
+    static QStringList ids(const QString& prefix, int count)
+    {
+        QStringList list;
+        for (int i = 0; i < count; ++i)
+            list.append(prefix + QString::number(i));
+        return list;
+    }
+
+private slots:
+    void init()
+    {
+        m_rows.clear();
+        m_index.clear();
+    }
+
+    void rebuildIndexesEveryRow()
+    {
+        rebuild(ids("m", 5));
+        verifyConsistent();
+        QVERIFY(m_index.contains("m4"));
+    }
+
+    void emptyIdsAreNotIndexed()
+    {
+        rebuild(QStringList() << "a" << QString() << "c");
+        verifyConsistent();
+        QVERIFY(!m_index.contains(QString()));
+        QCOMPARE(m_index.rowOf("c"), 2);
+    }
+
+    void prependMovesOnlyTheBase()
+    {
+        rebuild(ids("old", 10));
+        insert(0, ids("new", 3));
+        verifyConsistent();
+        QCOMPARE(m_index.rowOf("old0"), 3);
+        QCOMPARE(m_index.rowOf("new2"), 2);
+    }
+
+    void appendKeepsExistingRows()
+    {
+        rebuild(ids("m", 4));
+        insert(4, ids("tail", 2));
+        verifyConsistent();
+        QCOMPARE(m_index.rowOf("tail1"), 5);
+    }
+
+    void insertInTheMiddle_data()
+    {
+        QTest::addColumn<int>("row");
+        QTest::newRow("near front") << 2;
+        QTest::newRow("center") << 5;
+        QTest::newRow("near back") << 9;
+    }
+
+    void insertInTheMiddle()
+    {
+        QFETCH(int, row);
+        rebuild(ids("m", 10));
+        insert(row, ids("x", 3));
+        verifyConsistent();
+    }
+
+    void removeFromFrontAndBack()
+    {
+        rebuild(ids("m", 10));
+        remove(0, 3);
+        verifyConsistent();
+        QCOMPARE(m_index.rowOf("m3"), 0);
+        QVERIFY(!m_index.contains("m0"));
+
+        remove(m_rows.size() - 2, 2);
+        verifyConsistent();
+        QVERIFY(!m_index.contains("m9"));
+    }
+
+    void removeInTheMiddle_data()
+    {
+        QTest::addColumn<int>("row");
+        QTest::newRow("near front") << 1;
+        QTest::newRow("near back") << 7;
+    }
+
+    void removeInTheMiddle()
+    {
+        QFETCH(int, row);
+        rebuild(ids("m", 10));
+        remove(row, 2);
+        verifyConsistent();
+    }
+
+    void renumberAfterMove()
+    {
+        rebuild(ids("m", 6));
+        m_rows.move(4, 1);
+        m_index.renumber(1, 4, idAt());
+        verifyConsistent();
+        QCOMPARE(m_index.rowOf("m4"), 1);
+    }
+
+    void mixedEditsStayConsistent()
+    {
+        // A chat-like sequence: prepends, front trims and mid edits
+        rebuild(ids("m", 20));
+        for (int round = 0; round < 5; ++round) {
+            insert(0, ids(QStringLiteral("r%1_").arg(round), 4));
+            remove(m_rows.size() - 3, 3);
+            insert(m_rows.size() / 2, ids(QStringLiteral("mid%1_").arg(round), 1));
+            remove(1, 1);
+            verifyConsistent();
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(TestRowIndex)
+#include "tst_rowindex.moc"
@@ -245,12 +245,6 @@ void UserProfileCache::onProfileFetchFailed(int requestId, const QString& error)
 // Private helpers
 // ============================================================================
 
-void UserProfileCache::bumpVersion()
-{
-    m_version++;
-    emit versionChanged();
-}
-
 QString UserProfileCache::extractId(const QVariantMap& profile)
 {
     // Try common ID field names
@@ -8,6 +8,8 @@
 #include <QVariantList>
 #include <QString>
 
+#include "versionbatcher.h"
+
 class ApiClient;
 
 /**
@@ -102,7 +104,11 @@ public:
     /**
      * @brief Get version counter for QML binding invalidation.
      */
-    int version() const { return m_version; }
+    int version() const { return m_versions.version(); }
+    
+    /// Coalesce versionChanged() until endBatch() (see VersionBatcher)
+    void beginBatch() { m_versions.begin(); }
+    void endBatch() { if (m_versions.end()) emit versionChanged(); }
     
     // ========================================================================
     // C++ methods for cache management (also callable from QML)
@@ -177,12 +183,12 @@ private:
     QString m_baseUrl;
     
     // Version counter for QML binding invalidation
-    int m_version = 0;
+    VersionBatcher m_versions;
     
     /**
      * @brief Increment version and emit signal.
      */
-    void bumpVersion();
+    void bumpVersion() { if (m_versions.bump()) emit versionChanged(); }
     
     /**
      * @brief Extract user ID from profile data map.
@@ -0,0 +1,49 @@
+#ifndef VERSIONBATCHER_H
+#define VERSIONBATCHER_H
+
+/**
+ * @brief Version counter for the QML-facing caches, with batching.
+ *
+ * Every change bumps the version. Between begin() and the matching end()
+ * the notification is held back, so any number of changes inside a batch
+ * (e.g. one burst of socket events) produce a single versionChanged().
+ * The owning cache emits whenever bump() or end() returns true:
+ *
+ *     void bumpVersion() { if (m_versions.bump()) emit versionChanged(); }
+ *     void endBatch() { if (m_versions.end()) emit versionChanged(); }
+ */
+class VersionBatcher {
+public:
+    int version() const { return m_version; }
+
+    /// Count a change. Returns true if it should be signalled right away.
+    bool bump()
+    {
+        m_version++;
+        if (m_depth > 0) {
+            m_pending = true;
+            return false;
+        }
+        return true;
+    }
+
+    void begin() { m_depth++; }
+
+    /// Close a batch. Returns true if it was the outermost one and held changes.
+    bool end()
+    {
+        if (m_depth == 0 || --m_depth > 0) {
+            return false;
+        }
+        bool pending = m_pending;
+        m_pending = false;
+        return pending;
+    }
+
+private:
+    int m_version = 0;
+    int m_depth = 0;
+    bool m_pending = false;  // Bumped inside a batch, not yet signalled
+};
+
+#endif // VERSIONBATCHER_H
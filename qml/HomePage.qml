@@ -59,6 +59,8 @@ Page {
     property bool loadingServers: false
     property bool loadingChannels: false
     property bool loadingMessages: false
+    property bool showingCachedMessages: false
+    property int cachedMessagesRequestId: -1  // Fetch that replaces the cached paint
     // hasMoreMessages is now managed by SerchatAPI.messageModel.hasMoreMessages
     
     // Responsive layout threshold
@@ -181,6 +183,13 @@ Page {
                 }
             }
             
+            onLoadNewerMessages: {
+                // DM history isn't windowed, so this only happens in channels
+                if (currentDMRecipientId === "") {
+                    SerchatAPI.loadNewerMessages(currentServerId, currentChannelId, 50)
+                }
+            }
+            
             onUserProfileClicked: {
                 pageStack.push(Qt.resolvedUrl("ProfilePage.qml"), {
                     userId: userId,
@@ -789,8 +798,15 @@ Page {
                 loadingMessages = false
 
                 // Messages are already reversed in C++ (newest-first, ready for BottomToTop ListView)
-                // Just append them to the model
-                SerchatAPI.messageModel.appendMessages(fetchedMessages)
+                if (showingCachedMessages && requestId === cachedMessagesRequestId) {
+                    // The fresh latest page supersedes the cached snapshot
+                    showingCachedMessages = false
+                    cachedMessagesRequestId = -1
+                    SerchatAPI.messageModel.replaceMessages(fetchedMessages)
+                } else {
+                    // Just append them to the model
+                    SerchatAPI.messageModel.appendMessages(fetchedMessages)
+                }
 
                 console.log("[HomePage] Messages updated, total:", SerchatAPI.messageModel.count)
 
@@ -804,6 +820,11 @@ Page {
         onMessagesFetchFailed: {
             if (channelId === currentChannelId) {
                 loadingMessages = false
+                // Keep the cached paint; later pages must append to it
+                if (requestId === cachedMessagesRequestId) {
+                    showingCachedMessages = false
+                    cachedMessagesRequestId = -1
+                }
                 console.log("Failed to fetch messages:", error)
             }
         }
@@ -1378,7 +1399,12 @@ Page {
         // Mark channel as read on the server (sends mark_channel_read event)
         SerchatAPI.markChannelAsRead(serverId, channelId)
 
-        SerchatAPI.getMessages(serverId, channelId, 50, "")
+        // Paint whatever is cached (in memory or on disk) right away;
+        // the fresh page below replaces it when it arrives
+        showingCachedMessages = SerchatAPI.loadCachedMessages(serverId, channelId) > 0
+
+        var requestId = SerchatAPI.getMessages(serverId, channelId, 50, "")
+        cachedMessagesRequestId = showingCachedMessages ? requestId : -1
     }
     
     function loadOlderMessages() {
@@ -1395,6 +1421,11 @@ Page {
     function sendMessageToChannel(text, replyToId) {
         if (!currentServerId || !currentChannelId || !text) return
         
+        // Scrolled back past the resident window - return to the live end first
+        if (SerchatAPI.messageModel.hasNewerMessages) {
+            SerchatAPI.jumpToLatestMessages(currentServerId, currentChannelId)
+        }
+        
         // Optimistically add message to view using C++ model
         var newMessage = {
             _id: "temp_" + Date.now(),
@@ -1426,6 +1457,8 @@ Page {
         
         // Set DM mode and clear messages using proper model signals
         SerchatAPI.messageModel.setDMRecipient(recipientId)
+        showingCachedMessages = false
+        cachedMessagesRequestId = -1
         
         // Mark DM as read when viewing
         SerchatAPI.clearDMUnread(recipientId)
@@ -46,6 +46,7 @@ Rectangle {
     
     signal sendMessage(string text, string replyToId)
     signal loadMoreMessages()
+    signal loadNewerMessages()
     signal userProfileClicked(string userId)
     signal backClicked()
     signal viewFullProfile(string userId, string serverId)
@@ -55,20 +56,6 @@ Rectangle {
     
     color: Theme.palette.normal.background
 
-    // Listen for first unread message ID changes from C++
-    // The C++ side calculates this based on timestamps when messages are loaded
-    Connections {
-        target: SerchatAPI
-
-        onFirstUnreadMessageIdChanged: function(sId, chId, msgId) {
-            // Update the divider position when C++ calculates the first unread message
-            if (sId === serverId && chId === channelId) {
-                messageList.firstUnreadMessageId = msgId
-                console.log("[MessageView] First unread message ID set to:", msgId)
-            }
-        }
-    }
-    
     // Channel header
     Rectangle {
         id: channelHeader
@@ -239,10 +226,6 @@ Rectangle {
                 property real savedContentY: 0
                 property real savedContentHeight: 0
                 property int savedMessageCount: 0
-                
-                // Track the first unread message ID for "NEW MESSAGES" divider
-                // This is set by C++ after calculating based on timestamps
-                property string firstUnreadMessageId: ""
 
                 delegate: Item {
                     id: messageDelegateContainer
@@ -250,13 +233,8 @@ Rectangle {
                     height: messageBubble.height + (newMessagesDivider.visible ? newMessagesDivider.height : 0)
 
                     // Show "NEW MESSAGES" divider above this message if it's the first unread
-                    // The firstUnreadMessageId is calculated by C++ based on lastReadAt timestamps
-                    property bool isFirstUnread: {
-                        if (messageList.firstUnreadMessageId === "") return false
-                        // Check if this message is the first unread message
-                        var msgId = model.id || ""
-                        return msgId === messageList.firstUnreadMessageId
-                    }
+                    // The first unread message is tracked by MessageModel from lastReadAt timestamps
+                    property bool isFirstUnread: model.isFirstUnread || false
                     
                     // "NEW MESSAGES" divider
                     Rectangle {
@@ -307,7 +285,7 @@ Rectangle {
                         timestamp: model.timestamp || ""
                         isOwn: model.senderId === currentUserId
                         isEdited: model.isEdited || false
-                        showAvatar: SerchatAPI.messageModel.shouldShowAvatar(index)
+                        showAvatar: model.showAvatar
                         isReply: model.replyToId ? true : false
                         replyToText: model.repliedMessage ? model.repliedMessage.text : ""
                         replyToSender: model.repliedMessage ? getSenderName(model.repliedMessage.senderId) : ""
@@ -412,6 +390,10 @@ Rectangle {
                 // Pull to load more (debounced)
                 property bool loadingTriggered: false
                 
+                // The model keeps a bounded window; after scrolling far back its
+                // newest rows are dropped and paged back in at the bottom edge
+                property bool newerLoadingTriggered: false
+                
                 onContentYChanged: {
                     if (contentY < -units.gu(8) && !loading && hasMoreMessages && !loadingTriggered) {
                         loadingTriggered = true
@@ -420,6 +402,19 @@ Rectangle {
                     if (contentY >= 0) {
                         loadingTriggered = false
                     }
+                    
+                    if (atYEnd && SerchatAPI.messageModel.hasNewerMessages && !newerLoadingTriggered) {
+                        newerLoadingTriggered = true
+                        loadNewerMessages()
+                    }
+                    if (!atYEnd) {
+                        newerLoadingTriggered = false
+                    }
+                }
+                
+                Connections {
+                    target: SerchatAPI.messageModel
+                    onCountChanged: messageList.newerLoadingTriggered = false
                 }
             }
         
@@ -584,8 +579,6 @@ Rectangle {
         
         onSendMessage: {
             // Clear the "NEW MESSAGES" divider when user sends a message
-            messageList.firstUnreadMessageId = ""
-            // Also clear in C++ so it doesn't reappear on next load
             if (messageView.serverId && messageView.channelId) {
                 SerchatAPI.clearFirstUnreadMessageId(messageView.serverId, messageView.channelId)
             }